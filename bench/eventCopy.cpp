@@ -0,0 +1,34 @@
+#include <PNT/event.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+// Measures how fast events go through the path every input callback takes: created by value and passed by value through a function pointer.
+// Run it on two revisions to compare "windowEvent" layouts, the numbers only mean something relative to each other on the same machine.
+
+static volatile double sink;
+
+[[gnu::noinline]] static void consume(PNT::windowEvent event) {
+    sink = sink + event.cursorpos.xpos;
+}
+
+int main(int argc, char* argv[]) {
+    long long count = argc > 1 ? std::atoll(argv[1]) : 100000000;
+    void(*callback)(PNT::windowEvent) = consume;
+
+    // Warm up so the first timed iterations don't pay for page faults and frequency ramp up.
+    for(long long i = 0; i < count / 10; i++) {
+        callback(PNT::createCursorposEvent((double)i, (double)i));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for(long long i = 0; i < count; i++) {
+        callback(PNT::createCursorposEvent((double)i, (double)i));
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::printf("sizeof(windowEvent): %zu bytes\n", sizeof(PNT::windowEvent));
+    std::printf("%lld events in %.3f s: %.1fM events/s\n", count, elapsed.count(), count / elapsed.count() / 1e6);
+    return 0;
+}
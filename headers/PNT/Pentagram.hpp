@@ -3,7 +3,22 @@
 #include <PNT/error.hpp>
 #include <PNT/init.hpp>
 #include <PNT/event.hpp>
+#include <PNT/eventQueue.hpp>
+#include <PNT/listener.hpp>
 #include <PNT/window.hpp>
+#include <PNT/pacer.hpp>
+#include <PNT/stats.hpp>
+#include <PNT/gpuProfiler.hpp>
+#include <PNT/imguiRenderer.hpp>
+#include <PNT/resources.hpp>
+#include <PNT/drawSnapshot.hpp>
+#include <PNT/renderThread.hpp>
+#include <PNT/allocations.hpp>
+#include <PNT/trace.hpp>
+#include <PNT/capture.hpp>
+#include <PNT/video.hpp>
+#include <PNT/screenshot.hpp>
+#include <PNT/record.hpp>
 
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
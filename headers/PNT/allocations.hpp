@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace PNT {
+    /// @brief Checks if heap allocations are being counted (Pentagram has to be built with "PNT_TRACK_ALLOCATIONS").
+    /// @return True if "getAllocationCount()" is meaningful.
+    bool getAllocationTracking();
+
+    /// @brief Gets the number of heap allocations made through operator new since the program started.
+    /// @return The allocation count, always 0 without "PNT_TRACK_ALLOCATIONS".
+    uint64_t getAllocationCount();
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <glad/gl.h>
+
+namespace PNT {
+    class Window;
+
+    // A frame read back from the gpu, the pixels are only valid during the capture callback.
+    struct capturedFrame {
+        uint64_t frame;
+        int width;
+        int height;
+        // Tightly packed RGBA8 rows, bottom row first like glReadPixels.
+        std::span<const unsigned char> pixels;
+    };
+
+    // Reads frames into a ring of pixel pack buffers and hands them out once their fence has signaled, so capturing never waits on the gpu.
+    class frameCapture {
+    private:
+        static constexpr size_t ringSize = 3;
+
+        struct captureSlot {
+            GLuint buffer;
+            GLsync fence;
+            size_t size;
+            int width;
+            int height;
+            uint64_t frame;
+        };
+
+        GladGLContext* m_openglContext;
+        std::array<captureSlot, ringSize> m_slots;
+        size_t m_oldest;
+        size_t m_pending;
+        // Requests may come from another thread than the one capturing when rendering is threaded.
+        std::atomic<bool> m_continuous;
+        std::atomic<bool> m_requested;
+        std::atomic<uint64_t> m_dropped;
+        // Held while the callback runs, so a replaced callback is never called again once "setCallback()" returns.
+        std::mutex m_callbackMutex;
+        void(*m_callback)(Window*, const capturedFrame&, void*);
+        void* m_userData;
+
+    public:
+        frameCapture();
+
+        /// @brief Binds the capture to an opengl context, must be called with that context current.
+        /// @param openglContext The desired glad context.
+        void init(GladGLContext* openglContext);
+
+        /// @brief Frees the pixel buffers and fences, pending frames are discarded, must be called with the context current.
+        void shutdown();
+
+        /// @brief Sets the function that receives captured frames, from any thread. Waits for a running callback to return, so it must not be called from inside the callback.
+        /// @param callback The desired callback, called from "poll()" a few frames after the capture.
+        /// @param userData The desired pointer passed to the callback.
+        void setCallback(void(*callback)(Window*, const capturedFrame&, void*), void* userData);
+
+        /// @brief Captures every frame until disabled.
+        /// @param continuous The desired state.
+        void setContinuous(bool continuous);
+
+        /// @brief Captures the next frame.
+        void request();
+
+        /// @brief Checks if the current frame should be captured.
+        /// @return True if a capture was requested or capturing is continuous.
+        bool wanted() const;
+
+        /// @brief Gets the number of frames dropped because every buffer of the ring was still in flight.
+        /// @return The dropped frame count.
+        uint64_t getDropped() const;
+
+        /// @brief Starts reading the bound read framebuffer into the next buffer of the ring, the context must be current.
+        /// @param width The framebuffer width.
+        /// @param height The framebuffer height.
+        /// @param frame The frame number reported to the callback.
+        /// @return False if the frame was dropped.
+        bool capture(int width, int height, uint64_t frame);
+
+        /// @brief Delivers every finished capture in order without waiting for unfinished ones, the context must be current.
+        /// @param window The window passed to the callback.
+        void poll(Window* window);
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stddef.h>
+#include <imgui.h>
+
+namespace PNT {
+    // Deep copy of a frame's draw data, so it can be rendered while the next frame is being built, on the same thread or another one.
+    // The copied lists keep their buffers between copies, once they fit the biggest frame seen copying doesn't allocate anymore.
+    class drawDataSnapshot {
+    private:
+        ImDrawData m_drawData;
+        // Every list ever needed, only the first "m_drawData.CmdListsCount" are in use.
+        ImVector<ImDrawList*> m_lists;
+
+    public:
+        drawDataSnapshot();
+        ~drawDataSnapshot();
+
+        drawDataSnapshot(const drawDataSnapshot&) = delete;
+        drawDataSnapshot& operator=(const drawDataSnapshot&) = delete;
+
+        /// @brief Replaces the content of the snapshot with a copy of draw data.
+        /// @param drawData The desired draw data, usually "ImGui::GetDrawData()" right after "ImGui::Render()".
+        void copy(const ImDrawData* drawData);
+
+        /// @brief Gets the copied draw data, valid until the next "copy()" or "clear()".
+        /// @return The draw data, pass it to a renderer like the original.
+        ImDrawData* get();
+
+        /// @brief Frees every buffer of the snapshot, the next copy allocates them again.
+        void clear();
+
+        /// @brief Gets the memory kept by the snapshot for reuse.
+        /// @return The capacity of all list buffers in bytes.
+        size_t getCapacity() const;
+    };
+}
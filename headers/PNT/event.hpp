@@ -1,18 +1,62 @@
 #pragma once
 
-#include <vector>
-#include <string>
+#include <type_traits>
 #include <stdint.h>
 #include <stddef.h>
-#include <PNT/window.hpp>
 
 namespace PNT {
     class Window;
     struct windowEvent;
 
-    /// @brief Processes all pending events.
+    enum class eventTypes {
+        KEYBOARD,
+        CHAR,
+        DROP,
+        SCROLL,
+        CURSORPOS,
+        WINDOWPOS,
+        WINDOWSIZE,
+        CURSORENTER,
+        MOUSEBUTTON,
+        WINDOWFOCUS,
+        ICONIFY,
+        SCREENSHOT
+    };
+
+    inline constexpr size_t eventTypeCount = (size_t)eventTypes::SCREENSHOT + 1;
+
+    enum class eventLoopModes {
+        POLL,
+        WAIT
+    };
+
+    /// @brief Processes all pending events, in "eventLoopModes::WAIT" this blocks until there is something to do.
     void processEvents();
 
+    /// @brief Sets how "processEvents()" gets glfw events.
+    /// @param mode "POLL" never blocks, "WAIT" blocks until input, a pushed event or a requested wakeup arrives (the default is "POLL").
+    void setEventLoopMode(eventLoopModes mode);
+
+    /// @brief Gets the current event loop mode.
+    /// @return The mode set by "setEventLoopMode()".
+    eventLoopModes getEventLoopMode();
+
+    /// @brief Sets the longest time "processEvents()" may block in "eventLoopModes::WAIT".
+    /// @param seconds The desired maximum wait in seconds (0 or less waits without a limit).
+    void setEventWaitTimeout(double seconds);
+
+    /// @brief Sets how many extra frames are run without blocking after something woke the event loop, so imgui interactions can settle.
+    /// @param frames The desired number of frames (the default is 3).
+    void setEventSettleFrames(int frames);
+
+    /// @brief Makes sure "processEvents()" does not block past the given delay, use this for animation deadlines.
+    /// @param seconds The desired delay from now in seconds, only the earliest pending wakeup is kept.
+    void requestWakeup(double seconds);
+
+    /// @brief Makes the next calls of "processEvents()" return without blocking, use this while something animates every frame.
+    /// @param frames The desired number of frames to run without blocking.
+    void requestFrames(int frames);
+
     struct keyEvent {
         int key;
         int scancode;
@@ -25,7 +69,8 @@ namespace PNT {
     };
 
     struct dropEvent {
-        std::vector<std::string> paths;
+        int pathCount;
+        const char** paths;
     };
 
     struct scrollEvent {
@@ -62,26 +107,40 @@ namespace PNT {
         int focused;
     };
 
-    // Structure for events.
+    struct screenshotEvent {
+        uint64_t id;
+        bool succeeded;
+    };
+
+    // Structure for events, only the member matching "type" holds a valid value.
     struct windowEvent {
+        union {
+            keyEvent keyboard;
+            charEvent character;
+            dropEvent dropFiles;
+            scrollEvent scroll;
+            cursorposEvent cursorpos;
+            windowposEvent windowpos;
+            windowsizeEvent windowsize;
+            cursorEnterEvent cursorenter;
+            mousebuttonEvent mousebutton;
+            windowfocusEvent windowfocus;
+            bool iconified;
+            screenshotEvent screenshot;
+        };
         eventTypes type;
-        keyEvent keyboard;
-        charEvent character;
-        dropEvent dropFiles;
-        scrollEvent scroll;
-        cursorposEvent cursorpos;
-        windowposEvent windowpos;
-        windowsizeEvent windowsize;
-        cursorEnterEvent cursorenter;
-        mousebuttonEvent mousebutton;
-        windowfocusEvent windowfocus;
-        bool iconified;
-
-        const char* getTypename();
+
+        const char* getTypename() const;
     };
 
+    // Events are copied around on every input callback, keep them small and free of heap allocations.
+    static_assert(std::is_trivially_copyable_v<windowEvent>, "windowEvent must stay trivially copyable");
+    static_assert(sizeof(windowEvent) <= 24, "windowEvent payloads must stay compact");
+
     windowEvent createKeyEvent(int key, int scancode, int action, int mods);
     windowEvent createCharEvent(unsigned int codepoint);
+    /// @brief Creates a drop event that refers to the given paths without copying them.
+    /// @warning The paths must outlive the event, "Window::pushEvent()" stores its own copy so pushed drop events are always safe.
     windowEvent createDropEvent(int pathCount, const char* paths[]);
     windowEvent createScrollEvent(double xoffset, double yoffset);
     windowEvent createCursorposEvent(double xpos, double ypos);
@@ -91,4 +150,5 @@ namespace PNT {
     windowEvent createMousebuttonEvent(int button, int action, int mods);
     windowEvent createWindowFocusEvent(int focused);
     windowEvent createIconifyEvent(bool iconified);
+    windowEvent createScreenshotEvent(uint64_t id, bool succeeded);
 }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+
+namespace PNT {
+    struct windowEvent;
+
+    // Bounded lock-free multi-producer single-consumer queue of window events.
+    class eventQueue {
+    private:
+        struct cell;
+
+        std::unique_ptr<cell[]> m_cells;
+        size_t m_mask;
+        alignas(64) std::atomic<size_t> m_head;
+        alignas(64) size_t m_tail;
+
+    public:
+        eventQueue();
+        ~eventQueue();
+
+        /// @brief Allocates the queue storage, all queued events are discarded.
+        /// @param capacity The desired maximum number of queued events (rounded up to a power of two).
+        void allocate(size_t capacity);
+
+        /// @brief Frees the queue storage, all queued events are discarded.
+        void free();
+
+        /// @brief Pushes an event, safe to call from any thread.
+        /// @param event The desired event to push.
+        /// @return True if the event was queued and false if the queue is full.
+        bool push(const windowEvent& event);
+
+        /// @brief Pops the oldest event, must only be called from one thread at a time.
+        /// @param event The event that receives the popped value.
+        /// @return True if an event was popped and false if the queue is empty.
+        bool pop(windowEvent& event);
+
+        /// @brief Gets the maximum number of queued events.
+        /// @return The queue capacity.
+        size_t capacity() const;
+
+        /// @brief Gets the number of queued events, only exact when no other thread is pushing.
+        /// @return The approximate number of queued events.
+        size_t size() const;
+    };
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <stddef.h>
+#include <glad/gl.h>
+
+namespace PNT {
+    // GPU time of a named scope, read back a few frames after it was recorded.
+    struct gpuScopeResult {
+        const char* name;
+        int depth;
+        double time;
+    };
+
+    // Measures named GPU scopes with timestamp queries kept in a ring of frames so reading them back never stalls.
+    class gpuProfiler {
+    private:
+        static constexpr size_t frameLatency = 4;
+        static constexpr size_t maxScopes = 64;
+
+        struct scopeQuery {
+            const char* name;
+            int depth;
+        };
+
+        struct frameQueries {
+            std::array<GLuint, maxScopes * 2> queries;
+            std::array<scopeQuery, maxScopes> scopes;
+            size_t scopeCount;
+            size_t lastQuery;
+            bool recorded;
+        };
+
+        GladGLContext* m_openglContext;
+        std::atomic<bool> m_wantEnabled;
+        bool m_enabled;
+        bool m_inFrame;
+        std::array<frameQueries, frameLatency> m_frames;
+        size_t m_frameIndex;
+        std::vector<size_t> m_stack;
+        std::vector<gpuScopeResult> m_results;
+        mutable std::mutex m_resultsMutex;
+
+        void collect(frameQueries& frame);
+        void applyEnabled(bool enabled);
+    public:
+        gpuProfiler();
+        ~gpuProfiler();
+
+        /// @brief Binds the profiler to an opengl context, must be called with that context current.
+        /// @param openglContext The desired glad context.
+        void init(GladGLContext* openglContext);
+
+        /// @brief Frees all queries, must be called with the context current.
+        void shutdown();
+
+        /// @brief Enables or disables profiling from any thread, query objects are only created while enabled and the change applies at the next "beginFrame()".
+        /// @param enabled The desired state, ignored if the context doesn't support timer queries (OpenGL 3.3).
+        void setEnabled(bool enabled);
+
+        /// @brief Checks if profiling is enabled.
+        /// @return True if scopes are being measured or will be from the next frame on.
+        bool getEnabled() const;
+
+        /// @brief Starts a frame and collects the results of the oldest frame in the ring if the gpu is done with it.
+        void beginFrame();
+
+        /// @brief Ends the current frame, scopes left open are closed.
+        void endFrame();
+
+        /// @brief Opens a named scope, scopes can be nested.
+        /// @param name The desired scope name, the pointer is stored so it must outlive the profiler (use string literals).
+        void beginScope(const char* name);
+
+        /// @brief Closes the innermost open scope.
+        void endScope();
+
+        /// @brief Gets the results of the most recently collected frame.
+        /// @return A copy of the scopes in the order they were opened.
+        std::vector<gpuScopeResult> getResults() const;
+
+        /// @brief Gets the results of the most recently collected frame without copying.
+        /// @param results The vector that receives the results, its storage is reused.
+        void getResults(std::vector<gpuScopeResult>& results) const;
+    };
+
+    // Opens a gpu scope for the lifetime of the object.
+    class gpuScope {
+    private:
+        gpuProfiler& m_profiler;
+
+    public:
+        gpuScope(gpuProfiler& profiler, const char* name) : m_profiler(profiler) {
+            m_profiler.beginScope(name);
+        }
+
+        ~gpuScope() {
+            m_profiler.endScope();
+        }
+
+        gpuScope(const gpuScope&) = delete;
+        gpuScope& operator=(const gpuScope&) = delete;
+    };
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <glad/gl.h>
+
+namespace PNT {
+    // Offscreen EGL context with a framebuffer object standing in for the window surface, defined in headless.cpp.
+    struct headlessSurface;
+
+    /// @brief Creates an EGL context without a display server (surfaceless Mesa platform, falling back to a pbuffer) and makes it current.
+    /// @param width The desired framebuffer width.
+    /// @param height The desired framebuffer height.
+    /// @param openglContext The glad context that receives the opengl functions of the new context.
+    /// @return The surface, or nullptr if EGL is unavailable or no context could be created.
+    headlessSurface* createHeadlessSurface(int width, int height, GladGLContext* openglContext);
+
+    /// @brief Destroys the framebuffer and the EGL context, EGL is shut down with the last surface.
+    /// @param surface The surface to destroy.
+    void destroyHeadlessSurface(headlessSurface* surface);
+
+    /// @brief Makes the context of the surface current on the calling thread.
+    /// @param surface The desired surface.
+    /// @return True if the context was made current.
+    bool makeHeadlessCurrent(headlessSurface* surface);
+
+    /// @brief Resizes the framebuffer if its size changed, the context of the surface must be current.
+    /// @param surface The surface to resize.
+    /// @param width The desired framebuffer width.
+    /// @param height The desired framebuffer height.
+    void resizeHeadlessSurface(headlessSurface* surface, int width, int height);
+
+    /// @brief Gets the framebuffer object every frame of the surface is rendered into.
+    /// @param surface The desired surface.
+    /// @return The framebuffer name in the surface's context.
+    GLuint getHeadlessFramebuffer(const headlessSurface* surface);
+
+    /// @brief Gets the hidden context every headless context shares its objects with.
+    /// @return An opaque pointer identifying the share group, nullptr before the first surface.
+    const void* getHeadlessShareGroup();
+}
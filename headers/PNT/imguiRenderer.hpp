@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+#include <stddef.h>
+#include <glad/gl.h>
+#include <PNT/streamBuffer.hpp>
+
+struct ImDrawCmd;
+struct ImDrawData;
+struct ImDrawList;
+struct ImFontAtlas;
+struct ImGuiViewport;
+
+namespace PNT {
+    // Objects shared by every renderer whose context is in the same share group, defined in imguiRenderer.cpp.
+    struct rendererGroup;
+
+    // Renders imgui draw data, the shader program and font texture are created once per opengl share group instead of once per window.
+    class imguiRenderer {
+    private:
+        // Layout read by "glMultiDrawElementsIndirect()".
+        struct indirectCommand {
+            GLuint count;
+            GLuint instanceCount;
+            GLuint firstIndex;
+            GLint baseVertex;
+            GLuint baseInstance;
+        };
+
+        // Scissor box of a draw in window coordinates, the batch program discards fragments outside of it.
+        struct clipRect {
+            float left;
+            float bottom;
+            float right;
+            float top;
+        };
+
+        // A run of draws sharing a texture, or a user callback between runs.
+        struct drawBatch {
+            GLuint texture;
+            size_t first;
+            size_t count;
+            const ImDrawList* callbackList;
+            const ImDrawCmd* callback;
+        };
+
+        GladGLContext* m_openglContext;
+        rendererGroup* m_group;
+        GLuint m_fontTexture;
+        GLuint m_vertexArray;
+        // Vertices and indices of a whole frame go into one submission, platform windows orphan a buffer of their own since several contexts write it.
+        streamBuffer m_streamBuffer;
+        streamBuffer m_viewportBuffer;
+        bool m_hasVertexOffset;
+        // With OpenGL 4.3 whole runs of commands go out as one multi draw, the vectors are kept between frames.
+        bool m_batchDraws;
+        std::vector<indirectCommand> m_indirectCommands;
+        std::vector<clipRect> m_clipRects;
+        std::vector<drawBatch> m_batches;
+
+        void uploadFonts();
+        void setupRenderState(ImDrawData* drawData, int width, int height, GLuint vertexArray, GLuint buffer, bool batched);
+        void bindVertices(size_t offset);
+        void buildBatches(ImDrawData* drawData, int height);
+        void renderBatches(ImDrawData* drawData, int width, int height, GLuint vertexArray, streamBuffer& buffer, size_t clipStart, size_t commandStart);
+        void renderDrawData(ImDrawData* drawData, bool ownContext);
+        static void renderWindow(ImGuiViewport* viewport, void* renderArgument);
+
+    public:
+        imguiRenderer();
+
+        /// @brief Registers the renderer as the backend of the current imgui context, must be called with the opengl context current.
+        /// @param openglContext The desired glad context.
+        /// @param shareGroup Any pointer identifying the share group of the context (like the context every other one shares with), renderers with the same pointer share their program and font texture.
+        void init(GladGLContext* openglContext, const void* shareGroup);
+
+        /// @brief Frees the buffers of the renderer and the shared objects with the last renderer of the group, must be called with the imgui and opengl contexts current.
+        void shutdown();
+
+        /// @brief Uploads the font atlas to the share group if it changed since the last upload, must be called with the opengl context current.
+        void newFrame();
+
+        /// @brief Renders draw data into the current framebuffer.
+        /// @param drawData The desired draw data, usually "ImGui::GetDrawData()".
+        void render(ImDrawData* drawData);
+    };
+
+    /// @brief Gets the font atlas shared by every window, fonts added to it show up in all windows.
+    /// @return The atlas, created on first use and destroyed by "deinit()".
+    ImFontAtlas* getSharedFontAtlas();
+
+    /// @brief Builds the shared font atlas if fonts were added and hands the pixels to the renderers, must be called before "ImGui::NewFrame()" by the thread building the ui.
+    void prepareSharedFontAtlas();
+
+    /// @brief Destroys the shared font atlas, called by "deinit()" once every imgui context is gone.
+    void destroySharedFontAtlas();
+}
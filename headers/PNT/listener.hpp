@@ -0,0 +1,123 @@
+#pragma once
+
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <type_traits>
+#include <PNT/event.hpp>
+
+namespace PNT {
+    class Window;
+
+    // Maps an event type to the payload handed to its listeners.
+    template<eventTypes type>
+    struct eventPayload;
+
+    template<> struct eventPayload<eventTypes::KEYBOARD> { using type = keyEvent; static const type& get(const windowEvent& event) { return event.keyboard; } };
+    template<> struct eventPayload<eventTypes::CHAR> { using type = charEvent; static const type& get(const windowEvent& event) { return event.character; } };
+    template<> struct eventPayload<eventTypes::DROP> { using type = dropEvent; static const type& get(const windowEvent& event) { return event.dropFiles; } };
+    template<> struct eventPayload<eventTypes::SCROLL> { using type = scrollEvent; static const type& get(const windowEvent& event) { return event.scroll; } };
+    template<> struct eventPayload<eventTypes::CURSORPOS> { using type = cursorposEvent; static const type& get(const windowEvent& event) { return event.cursorpos; } };
+    template<> struct eventPayload<eventTypes::WINDOWPOS> { using type = windowposEvent; static const type& get(const windowEvent& event) { return event.windowpos; } };
+    template<> struct eventPayload<eventTypes::WINDOWSIZE> { using type = windowsizeEvent; static const type& get(const windowEvent& event) { return event.windowsize; } };
+    template<> struct eventPayload<eventTypes::CURSORENTER> { using type = cursorEnterEvent; static const type& get(const windowEvent& event) { return event.cursorenter; } };
+    template<> struct eventPayload<eventTypes::MOUSEBUTTON> { using type = mousebuttonEvent; static const type& get(const windowEvent& event) { return event.mousebutton; } };
+    template<> struct eventPayload<eventTypes::WINDOWFOCUS> { using type = windowfocusEvent; static const type& get(const windowEvent& event) { return event.windowfocus; } };
+    template<> struct eventPayload<eventTypes::ICONIFY> { using type = bool; static const type& get(const windowEvent& event) { return event.iconified; } };
+    template<> struct eventPayload<eventTypes::SCREENSHOT> { using type = screenshotEvent; static const type& get(const windowEvent& event) { return event.screenshot; } };
+
+    // Callable stored inline (no heap allocation) together with the function that unpacks the payload for it.
+    class eventListener {
+    private:
+        static constexpr size_t storageSize = 6 * sizeof(void*);
+
+        alignas(std::max_align_t) unsigned char m_storage[storageSize];
+        void(*m_invoke)(const void*, Window*, const windowEvent&);
+        void(*m_relocate)(void*, void*);
+        size_t m_id;
+        bool m_active;
+
+        template<typename callable>
+        static void relocate(void* destination, void* source) {
+            callable* function = static_cast<callable*>(source);
+            if(destination != nullptr) {
+                ::new(destination) callable(std::move(*function));
+            }
+            function->~callable();
+        }
+
+        eventListener() : m_invoke(nullptr), m_relocate(nullptr), m_id(0), m_active(false) {
+        }
+
+    public:
+        template<eventTypes type, typename callable>
+        static eventListener create(size_t id, callable&& function) {
+            using stored = std::decay_t<callable>;
+            using payload = typename eventPayload<type>::type;
+            static_assert(std::is_invocable_v<const stored&, Window*, const payload&>, "Listener must be callable with (PNT::Window*, const payload&)");
+            static_assert(sizeof(stored) <= storageSize && alignof(stored) <= alignof(std::max_align_t), "Listener captures too much state to be stored inline, capture a pointer instead");
+            static_assert(std::is_nothrow_move_constructible_v<stored>, "Listener must be nothrow move constructible");
+
+            eventListener listener;
+            ::new(static_cast<void*>(listener.m_storage)) stored(std::forward<callable>(function));
+            listener.m_invoke = [](const void* storage, Window* window, const windowEvent& event) {
+                (*static_cast<const stored*>(storage))(window, eventPayload<type>::get(event));
+            };
+            listener.m_relocate = &relocate<stored>;
+            listener.m_id = id;
+            listener.m_active = true;
+            return listener;
+        }
+
+        eventListener(eventListener&& other) noexcept : m_invoke(other.m_invoke), m_relocate(other.m_relocate), m_id(other.m_id), m_active(other.m_active) {
+            if(m_relocate != nullptr) {
+                m_relocate(m_storage, other.m_storage);
+                other.m_relocate = nullptr;
+            }
+        }
+
+        eventListener& operator=(eventListener&& other) noexcept {
+            if(this != &other) {
+                if(m_relocate != nullptr) {
+                    m_relocate(nullptr, m_storage);
+                }
+                m_invoke = other.m_invoke;
+                m_relocate = other.m_relocate;
+                m_id = other.m_id;
+                m_active = other.m_active;
+                if(m_relocate != nullptr) {
+                    m_relocate(m_storage, other.m_storage);
+                    other.m_relocate = nullptr;
+                }
+            }
+            return *this;
+        }
+
+        eventListener(const eventListener&) = delete;
+        eventListener& operator=(const eventListener&) = delete;
+
+        ~eventListener() {
+            if(m_relocate != nullptr) {
+                m_relocate(nullptr, m_storage);
+            }
+        }
+
+        void operator()(Window* window, const windowEvent& event) const {
+            if(m_active) {
+                m_invoke(m_storage, window, event);
+            }
+        }
+
+        size_t id() const {
+            return m_id;
+        }
+
+        bool active() const {
+            return m_active;
+        }
+
+        void deactivate() {
+            m_active = false;
+        }
+    };
+}
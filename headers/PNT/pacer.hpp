@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+
+namespace PNT {
+    // Caps a loop to a target rate with a coarse sleep followed by a short spin on the steady clock.
+    class framePacer {
+    private:
+        std::chrono::steady_clock::duration m_period;
+        std::chrono::steady_clock::duration m_spinThreshold;
+        std::chrono::steady_clock::duration m_sleepError;
+        std::chrono::steady_clock::time_point m_deadline;
+        std::chrono::duration<double> m_slack;
+        double m_targetFPS;
+
+    public:
+        framePacer();
+        ~framePacer();
+
+        /// @brief Sets the target rate.
+        /// @param fps The desired frames per second (0 or less disables pacing).
+        void setTargetFPS(double fps);
+
+        /// @brief Sets how long before the deadline the pacer stops sleeping and starts spinning.
+        /// @param spinThreshold The desired minimum spin time, the pacer raises it on its own if the os oversleeps.
+        void setSpinThreshold(std::chrono::duration<double> spinThreshold);
+
+        /// @brief Blocks until the next frame deadline, returns right away when pacing is disabled.
+        void wait();
+
+        /// @brief Gets the target rate.
+        /// @return The target frames per second (0 if pacing is disabled).
+        double getTargetFPS() const;
+
+        /// @brief Gets how much time was left before the deadline when the last "wait()" started.
+        /// @return The slack of the last frame, negative if the frame was late.
+        std::chrono::duration<double> getSlack() const;
+    };
+}
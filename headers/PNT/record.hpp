@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+
+namespace PNT {
+    class Window;
+    struct windowEvent;
+
+    enum class replayModes {
+        REALTIME,
+        UNTHROTTLED
+    };
+
+    /// @brief Starts recording every glfw input event of every window to a binary event log.
+    /// @param path The desired path of the event log (overwritten if it exists).
+    /// @return True if the recording started and false if the file could not be opened or a replay is running.
+    bool startRecording(const std::string& path);
+
+    /// @brief Stops the current recording and closes the event log.
+    void stopRecording();
+
+    /// @brief Checks if events are being recorded.
+    /// @return True if a recording is running.
+    bool isRecording();
+
+    /// @brief Starts replaying an event log through the same callbacks as live input, live input still updates window state and imgui but isn't dispatched to the app until the replay ends.
+    /// @param path The path of an event log written by "startRecording()".
+    /// @param mode "REALTIME" replays events at their recorded timestamps, "UNTHROTTLED" replays them on their recorded "processEvents()" call so the app can run as fast as it can.
+    /// @return True if the replay started and false if the file could not be mapped or is not a valid event log.
+    /// @warning Windows are matched by creation order since "init()", so create (and destroy) them in the same order as during the recording.
+    bool startReplay(const std::string& path, replayModes mode);
+
+    /// @brief Stops the current replay and unmaps the event log.
+    void stopReplay();
+
+    /// @brief Checks if an event log is being replayed.
+    /// @return True if a replay is running.
+    bool isReplaying();
+
+    // Hooks used by the event system.
+
+    /// @brief Records a glfw input event if a recording is running.
+    /// @return False if live input shouldn't reach the app because a replay is running, window state and imgui are still updated.
+    bool captureInputEvent(const Window* window, const windowEvent& event);
+
+    /// @brief Advances the event frame counter and feeds due replayed events, called at the start of "processEvents()".
+    void beginEventFrame();
+}
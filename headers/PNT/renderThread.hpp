@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+#include <imgui.h>
+#include <PNT/drawSnapshot.hpp>
+
+namespace PNT {
+    class Window;
+
+    // A frame built by the ui thread, deep copied so the next one can be built while the render thread draws it.
+    // Snapshots are pooled per window and go back to the pool once drawn, so their buffers are reused by later frames.
+    struct frameSnapshot {
+        drawDataSnapshot drawData;
+        int width;
+        int height;
+        float clearColor[4];
+        uint64_t frame;
+        int swapInterval;
+    };
+
+    /// @brief Moves rendering and swapping of every window onto a dedicated thread, "processEvents()" and the ui keep running on the main thread and hand frames over through a bounded queue.
+    /// Headless windows and windows with imgui viewports enabled keep rendering on the main thread. Capture callbacks and imgui draw callbacks of threaded windows are called from the render thread.
+    /// @return True if the thread is running, false if a window is inside a frame (call this between frames).
+    bool startRenderThread();
+
+    /// @brief Stops the render thread after its current frame, queued frames are dropped and the contexts go back to the main thread.
+    void stopRenderThread();
+
+    /// @brief Checks if the render thread is running.
+    /// @return True if windows are rendered on the render thread.
+    bool isRenderThreadRunning();
+
+    /// @brief Gets how many frames were dropped because the render thread fell behind a window with a target fps, the newest frames are always kept.
+    /// Windows without a target fps wait for the render thread instead of dropping.
+    /// @return The dropped frame count since the render thread was started.
+    uint64_t getRenderThreadDropped();
+
+    // Hooks used by windows.
+
+    /// @brief Hands the context of a window to the render thread, the context must not be current on another thread afterwards.
+    /// @param window The desired window.
+    void attachRenderThread(Window* window);
+
+    /// @brief Waits until the render thread is done with a window and gives its context back to the calling thread.
+    /// @param window The desired window.
+    void detachRenderThread(Window* window);
+
+    /// @brief Copies draw data into a pooled snapshot queued for a window, if the queue is full the oldest queued frame is dropped unless the call blocks.
+    /// @param window The window the frame belongs to.
+    /// @param drawData The desired draw data.
+    /// @param width The framebuffer width.
+    /// @param height The framebuffer height.
+    /// @param clearColor The desired clear color.
+    /// @param frame The frame number.
+    /// @param swapInterval The swap interval of the window.
+    /// @param blocking True to wait until the render thread took the previous frame instead of dropping frames, for windows nothing else paces.
+    void submitRenderFrame(Window* window, const ImDrawData* drawData, int width, int height, const float clearColor[4], uint64_t frame, int swapInterval, bool blocking);
+
+    /// @brief Body of the render thread.
+    void renderThreadLoop();
+}
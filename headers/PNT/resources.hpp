@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <glad/gl.h>
+
+namespace PNT {
+    enum class resourceTypes {
+        TEXTURE,
+        BUFFER,
+        PROGRAM
+    };
+
+    // Reference count and name of a resource, defined in resources.cpp.
+    struct resourceControl;
+
+    // Reference counted handle to an opengl object living in a share group, usable by every window of that group (all windowed ones, or all headless ones).
+    // The object is deleted once the last handle is gone, the next frame of any window in the group, so handles can be dropped from any thread or context.
+    class gpuResource {
+    private:
+        resourceControl* m_control;
+
+    public:
+        gpuResource();
+        explicit gpuResource(resourceControl* control);
+        gpuResource(const gpuResource& other);
+        gpuResource(gpuResource&& other) noexcept;
+        ~gpuResource();
+
+        gpuResource& operator=(const gpuResource& other);
+        gpuResource& operator=(gpuResource&& other) noexcept;
+
+        /// @brief Gets the opengl name of the object, bind it with the usual gl calls or pass it to "ImGui::Image()".
+        /// @return The name, or 0 for an empty handle.
+        GLuint get() const;
+
+        /// @brief Gets the kind of object the handle refers to.
+        /// @return The resource type, "TEXTURE" for an empty handle.
+        resourceTypes getType() const;
+
+        /// @brief Checks if the handle refers to an object.
+        /// @return True if the handle isn't empty.
+        bool valid() const;
+
+        /// @brief Drops the reference held by the handle and empties it.
+        void reset();
+    };
+
+    // Hooks used by windows, resources are created with "Window::createTexture()", "Window::createBuffer()" and "Window::createProgram()".
+
+    /// @brief Wraps a freshly created object in a handle holding the first reference.
+    /// @param shareGroup The share group the object was created in.
+    /// @param type The kind of object.
+    /// @param name The opengl name of the object.
+    /// @param key A name under which the resource can be found with "findResource()", empty to not cache it.
+    /// @return The handle.
+    gpuResource createResource(const void* shareGroup, resourceTypes type, GLuint name, const std::string& key);
+
+    /// @brief Looks up a resource created with a key that still has live handles.
+    /// @param shareGroup The desired share group.
+    /// @param key The key passed to "createResource()".
+    /// @return A new handle to the resource, or an empty handle.
+    gpuResource findResource(const void* shareGroup, const std::string& key);
+
+    /// @brief Deletes every object of the group whose last handle was dropped, a context of the group must be current.
+    /// @param shareGroup The desired share group.
+    /// @param openglContext The glad context of the current context.
+    void flushResources(const void* shareGroup, GladGLContext* openglContext);
+
+    /// @brief Forgets a share group whose last context is being destroyed, its objects go with it and handles still referring to them are left dangling.
+    /// @param shareGroup The desired share group.
+    void releaseResourceGroup(const void* shareGroup);
+}
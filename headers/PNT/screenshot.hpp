@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+namespace PNT {
+    class Window;
+
+    // Hooks used by windows, screenshots are requested with "Window::requestScreenshot()".
+
+    /// @brief Queues a captured frame for PNG encoding on the screenshot thread, completion is reported with a "SCREENSHOT" event pushed to the window.
+    /// @param window The window the screenshot belongs to.
+    /// @param id The id returned by "Window::requestScreenshot()".
+    /// @param path The desired path of the PNG file.
+    /// @param width The width of the frame.
+    /// @param height The height of the frame.
+    /// @param pixels Bottom-up RGBA8 rows as read by glReadPixels.
+    void queueScreenshot(Window* window, uint64_t id, std::string path, int width, int height, std::vector<unsigned char>&& pixels);
+
+    /// @brief Blocks until every queued screenshot of a window was written.
+    /// @param window The desired window.
+    void waitForScreenshots(const Window* window);
+
+    /// @brief Finishes every queued screenshot and stops the screenshot thread, called by "deinit()".
+    void stopScreenshots();
+
+    /// @brief Body of the screenshot thread.
+    void screenshotLoop();
+}
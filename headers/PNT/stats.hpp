@@ -0,0 +1,87 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <stddef.h>
+
+namespace PNT {
+    enum class frameMetrics {
+        FRAME,
+        CPU,
+        SWAP,
+        EVENTS
+    };
+
+    inline constexpr size_t frameMetricCount = (size_t)frameMetrics::EVENTS + 1;
+
+    // Timings of one frame in seconds.
+    struct frameTiming {
+        double frame;
+        double cpu;
+        double swap;
+        double events;
+    };
+
+    struct frameSummary {
+        double p50;
+        double p95;
+        double p99;
+        double max;
+    };
+
+    // Sliding window of frame timings kept in a ring buffer.
+    class frameStats {
+    private:
+        std::vector<frameTiming> m_samples;
+        size_t m_next;
+        size_t m_count;
+        mutable std::vector<double> m_scratch;
+
+        void gather(frameMetrics metric) const;
+    public:
+        /// @brief Frame statistics constructor.
+        /// @param capacity The desired number of frames in the sliding window.
+        frameStats(size_t capacity = 240);
+
+        /// @brief Sets the number of frames in the sliding window, all samples are discarded.
+        /// @param capacity The desired number of frames.
+        void setCapacity(size_t capacity);
+
+        /// @brief Adds the timings of a frame, the oldest frame is dropped once the window is full.
+        /// @param timing The timings of the frame.
+        void addSample(const frameTiming& timing);
+
+        /// @brief Discards all samples.
+        void clear();
+
+        /// @brief Gets the number of frames currently in the sliding window.
+        /// @return The number of samples.
+        size_t size() const;
+
+        /// @brief Gets the number of frames the sliding window can hold.
+        /// @return The capacity.
+        size_t capacity() const;
+
+        /// @brief Gets a sample by age.
+        /// @param age The age of the sample, 0 is the latest frame.
+        /// @return The timings of the frame.
+        const frameTiming& sample(size_t age) const;
+
+        /// @brief Gets one metric of a sample by age.
+        /// @param metric The desired metric.
+        /// @param age The age of the sample, 0 is the latest frame.
+        /// @return The metric in seconds.
+        double value(frameMetrics metric, size_t age) const;
+
+        /// @brief Gets a percentile of a metric over the sliding window.
+        /// @param metric The desired metric.
+        /// @param percent The desired percentile from 0 to 100.
+        /// @return The percentile in seconds (0 if there are no samples).
+        double percentile(frameMetrics metric, double percent) const;
+
+        /// @brief Gets the p50, p95, p99 and max of a metric over the sliding window.
+        /// @param metric The desired metric.
+        /// @return The summary in seconds (all 0 if there are no samples).
+        frameSummary summary(frameMetrics metric) const;
+    };
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <stddef.h>
+#include <glad/gl.h>
+
+namespace PNT {
+    // Buffer the cpu fills once per submission and the gpu reads a few frames later, without reallocating or syncing in the driver.
+    // With OpenGL 4.4 it's a persistently mapped ring of regions guarded by fences, otherwise the storage is orphaned and mapped for every submission.
+    class streamBuffer {
+    private:
+        static constexpr size_t regionCount = 3;
+
+        GladGLContext* m_openglContext;
+        GLuint m_buffer;
+        bool m_persistent;
+        unsigned char* m_mapped;
+        size_t m_regionSize;
+        size_t m_region;
+        size_t m_capacity;
+        std::array<GLsync, regionCount> m_fences;
+
+        void allocatePersistent(size_t regionSize);
+        void waitRegion(size_t region);
+
+    public:
+        streamBuffer();
+
+        /// @brief Binds the buffer to an opengl context, must be called with that context current.
+        /// @param openglContext The desired glad context.
+        /// @param persistent Use a persistently mapped ring if the context supports OpenGL 4.4, false to always orphan (needed when several contexts write the buffer).
+        void init(GladGLContext* openglContext, bool persistent);
+
+        /// @brief Frees the buffer and its fences, must be called with a context of the share group current.
+        void shutdown();
+
+        /// @brief Reserves space for one submission and binds the buffer to "GL_ARRAY_BUFFER", waits only if the gpu is still reading the region from "regionCount" submissions ago.
+        /// @param size The desired size in bytes.
+        /// @return Where to write the data, valid until "end()", or nullptr if mapping failed (don't call "end()" then).
+        unsigned char* begin(size_t size);
+
+        /// @brief Makes the data written since "begin()" visible to the gpu, call it before drawing from the buffer and with the buffer still bound to "GL_ARRAY_BUFFER".
+        void end();
+
+        /// @brief Marks the current region as in use by everything drawn so far, call it after the last draw reading the submission.
+        void finish();
+
+        /// @brief Gets the byte offset of the last submission in the buffer, add it to the offsets of attribute pointers and indices, it is always a multiple of 256.
+        /// @return The offset.
+        size_t getOffset() const;
+
+        /// @brief Gets the buffer object.
+        /// @return The opengl name, 0 before the first submission.
+        GLuint getBuffer() const;
+
+        /// @brief Checks if the buffer is a persistently mapped ring.
+        /// @return False if it orphans its storage instead.
+        bool isPersistent() const;
+    };
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <stdint.h>
+
+namespace PNT {
+    // Set while a trace is being captured, read inline so disabled zones cost a single relaxed load.
+    inline std::atomic<bool> tracingActive = false;
+
+    /// @brief Starts capturing trace zones from every thread, any previous capture is discarded.
+    void startTracing();
+
+    /// @brief Stops capturing and writes the zones in the Chrome trace event format (open it in chrome://tracing or ui.perfetto.dev).
+    /// @param path The desired path of the trace file (overwritten if it exists).
+    /// @return True if the trace was written.
+    bool stopTracing(const std::string& path);
+
+    /// @brief Checks if trace zones are being captured.
+    /// @return True if tracing is running.
+    inline bool isTracing() {
+        return tracingActive.load(std::memory_order_relaxed);
+    }
+
+    /// @brief Starts the flight recorder, which keeps the zones of the last frames in a fixed-size ring and writes them to a trace file whenever a frame goes over budget.
+    /// @param directory The directory that receives one "hitch-<index>-<time>ms.json" trace per slow frame.
+    /// @param budget The desired frame budget in seconds, measured from "startFrame()" to the end of "endFrame()".
+    /// @param frames The number of frames kept before the slow one (a frame is one "processEvents()" call).
+    /// @param zonesPerFrame The number of zones budgeted per frame, the ring holds frames * zonesPerFrame zones.
+    /// @return False if tracing is already running.
+    bool startFlightRecorder(const std::string& directory, double budget, size_t frames = 120, size_t zonesPerFrame = 256);
+
+    /// @brief Stops the flight recorder, traces of earlier hitches are written before it returns.
+    void stopFlightRecorder();
+
+    /// @brief Checks if the flight recorder is running.
+    /// @return True if slow frames are being captured.
+    bool isFlightRecording();
+
+    /// @brief Hands the zones recorded by the calling thread to the trace, zones of other threads only show up once their buffer fills up, the thread exits or it calls this.
+    void flushTracing();
+
+    /// @brief Records a finished zone, use "traceZone" instead.
+    void recordTraceZone(const char* name, int64_t begin, int64_t end);
+
+    /// @brief Marks the start of a frame for the flight recorder and writes out the last slow frame, called by "processEvents()".
+    void markTraceFrame();
+
+    /// @brief Reports the duration of a frame to the flight recorder, called by "endFrame()".
+    /// @param seconds The time from "startFrame()" to the end of "endFrame()".
+    void traceFrameTime(double seconds);
+
+    /// @brief Gets the trace clock.
+    /// @return Nanoseconds on the steady clock.
+    int64_t traceClock();
+
+    // Traces the lifetime of the object as a named zone on the calling thread.
+    class traceZone {
+    private:
+        const char* m_name;
+        int64_t m_begin;
+
+    public:
+        /// @brief Opens a zone if tracing is running.
+        /// @param name The desired zone name, the pointer is stored until the trace is written so it must be a string literal or outlive the trace.
+        traceZone(const char* name) : m_name(nullptr), m_begin(0) {
+            if(isTracing()) {
+                m_name = name;
+                m_begin = traceClock();
+            }
+        }
+
+        ~traceZone() {
+            if(m_name != nullptr) {
+                recordTraceZone(m_name, m_begin, traceClock());
+            }
+        }
+
+        traceZone(const traceZone&) = delete;
+        traceZone& operator=(const traceZone&) = delete;
+    };
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace PNT {
+    class Window;
+    struct capturedFrame;
+
+    enum class videoFormats {
+        Y4M,
+        RAW_RGBA,
+        PNG
+    };
+
+    // Records captured frames on worker threads, the render thread only copies each frame into a pooled buffer.
+    class videoRecorder {
+    private:
+        struct videoJob {
+            uint64_t sequence;
+            uint64_t frame;
+            int width;
+            int height;
+            std::vector<unsigned char> pixels;
+            std::vector<unsigned char> converted;
+            bool done;
+        };
+
+        videoFormats m_format;
+        std::string m_path;
+        FILE* m_file;
+        bool m_pipe;
+        int m_fps;
+        int m_width;
+        int m_height;
+        uint64_t m_sequence;
+        std::atomic<uint64_t> m_dropped;
+        std::atomic<uint64_t> m_written;
+        std::atomic<bool> m_failed;
+
+        std::vector<std::unique_ptr<videoJob>> m_jobs;
+        std::vector<videoJob*> m_free;
+        std::deque<videoJob*> m_convertQueue;
+        std::deque<videoJob*> m_inFlight;
+        std::mutex m_mutex;
+        std::condition_variable m_convertCondition;
+        std::condition_variable m_writeCondition;
+        std::vector<std::thread> m_workers;
+        std::thread m_writer;
+        bool m_stopping;
+
+        void workerLoop();
+        void writerLoop();
+        void convert(videoJob& job);
+    public:
+        videoRecorder();
+        ~videoRecorder();
+
+        videoRecorder(const videoRecorder&) = delete;
+        videoRecorder& operator=(const videoRecorder&) = delete;
+
+        /// @brief Starts a recording.
+        /// @param path The desired output, a file path, "-" for stdout or "|command" to pipe into a command (like an encoder), for "PNG" a printf pattern taking the frame number as unsigned long long ("frames/%06llu.png").
+        /// @param format "Y4M" writes 4:2:0 YUV4MPEG2, "RAW_RGBA" writes top-down RGBA8 frames and "PNG" writes one image per frame.
+        /// @param fps The frame rate written to the Y4M header.
+        /// @param maxBufferedFrames The number of frames that can wait for the workers, frames arriving while all of them are busy are dropped.
+        /// @param workers The number of conversion and encoding threads.
+        /// @return False if a recording is already running or the output could not be opened.
+        bool start(const std::string& path, videoFormats format, int fps = 60, size_t maxBufferedFrames = 8, unsigned int workers = 2);
+
+        /// @brief Stops the recording after every buffered frame was written.
+        void stop();
+
+        /// @brief Checks if a recording is running.
+        /// @return True between "start()" and "stop()".
+        bool isRecording() const;
+
+        /// @brief Hands a frame to the workers, the pixels are copied so the frame can be released right after.
+        /// @param frame The captured frame, frames with a different size than the first one are dropped for streamed formats.
+        /// @return False if the frame was dropped.
+        bool submit(const capturedFrame& frame);
+
+        /// @brief Routes the captures of a window into the recorder and turns on continuous capture.
+        /// @param window The desired window.
+        void attach(Window* window);
+
+        /// @brief Stops the captures of a window and removes the recorder as its capture callback.
+        /// @param window The window passed to "attach()".
+        void detach(Window* window);
+
+        /// @brief Gets the number of frames dropped because the workers or the output fell behind.
+        /// @return The dropped frame count.
+        uint64_t getDropped() const;
+
+        /// @brief Gets the number of frames written.
+        /// @return The written frame count.
+        uint64_t getWritten() const;
+
+        /// @brief A capture callback that submits frames to the recorder passed as user data.
+        static void captureCallback(Window* window, const capturedFrame& frame, void* recorder);
+    };
+}
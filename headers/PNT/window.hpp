@@ -1,11 +1,29 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <vector>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <span>
 #include <chrono>
+#include <stddef.h>
+#include <stdint.h>
 #include <imgui.h>
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
+#include <PNT/event.hpp>
+#include <PNT/eventQueue.hpp>
+#include <PNT/listener.hpp>
+#include <PNT/pacer.hpp>
+#include <PNT/stats.hpp>
+#include <PNT/gpuProfiler.hpp>
+#include <PNT/headless.hpp>
+#include <PNT/capture.hpp>
+#include <PNT/imguiRenderer.hpp>
+#include <PNT/resources.hpp>
+#include <PNT/renderThread.hpp>
 
 struct GLFWmonitor;
 struct GLFWwindow;
@@ -16,33 +34,30 @@ struct GladGLContext;
 
 namespace PNT {
     class Window;
-    struct windowEvent;
 
     void monitorCallback(GLFWmonitor*, int);
 
-    enum class eventTypes {
-        KEYBOARD,
-        CHAR,
-        DROP,
-        SCROLL,
-        CURSORPOS,
-        WINDOWPOS,
-        WINDOWSIZE,
-        CURSORENTER,
-        MOUSEBUTTON,
-        WINDOWFOCUS,
-        ICONIFY
-    };
-
     enum class vsyncModes {
         ADAPTIVE = -1,
         OFF,
         ON,
     };
 
+    enum class renderModes {
+        CONTINUOUS,
+        REACTIVE
+    };
+
+    enum class coalesceModes {
+        OFF,
+        LATEST,
+        LATEST_WITH_HISTORY
+    };
+
     class callbackManagers {
     private:
         friend class Window;
+        friend void beginEventFrame();
 
         static void keyCallbackManager(GLFWwindow*, int, int, int, int);
         static void charCallbackManager(GLFWwindow*, unsigned int);
@@ -55,10 +70,31 @@ namespace PNT {
         static void mousebuttonCallbackManager(GLFWwindow*, int, int, int);
         static void windowFocusCallback(GLFWwindow*, int);
         static void iconifyCallbackManager(GLFWwindow*, int);
+        static void windowRefreshCallbackManager(GLFWwindow*);
+    };
+
+    // Owned copy of the paths of a pushed drop event, kept alive until the event is dispatched.
+    struct dropStorage {
+        std::vector<std::string> paths;
+        std::vector<const char*> pointers;
+    };
+
+    // Screenshot requested by "requestScreenshot()", frame is the rendered frame it was read back from.
+    struct pendingScreenshot {
+        uint64_t id;
+        uint64_t frame;
+        std::string path;
+    };
+
+    // Timestamped copy of a coalesced event, the time is in seconds as returned by "glfwGetTime()".
+    struct eventSample {
+        double time;
+        windowEvent event;
     };
 
     struct windowData {
         void(*eventCallback)(Window*, windowEvent);
+        void(*eventBatchCallback)(Window*, std::span<const windowEvent>);
         std::string title;
         int width, height, xpos, ypos;
         ImGuiConfigFlags ImGuiFlags;
@@ -68,33 +104,125 @@ namespace PNT {
         vsyncModes vsyncMode;
         float clearColor[4];
         void* userPointer;
-
-        windowData() : eventCallback(nullptr), title{0}, width(128), height(128), xpos(GLFW_DONT_CARE), ypos(GLFW_DONT_CARE), ImGuiFlags(0), focused(false), hidden(false), iconified(false), vsyncMode(vsyncModes::OFF), clearColor{0.0f, 0.0f, 0.0f, 1.0f}, userPointer(nullptr) {
+        size_t eventQueueSize;
+        coalesceModes coalesceMode;
+        renderModes renderMode;
+        double targetFPS;
+        bool performanceOverlay;
+        bool headless;
+
+        windowData() : eventCallback(nullptr), eventBatchCallback(nullptr), title{0}, width(128), height(128), xpos(GLFW_DONT_CARE), ypos(GLFW_DONT_CARE), ImGuiFlags(0), focused(false), hidden(false), iconified(false), vsyncMode(vsyncModes::OFF), clearColor{0.0f, 0.0f, 0.0f, 1.0f}, userPointer(nullptr), eventQueueSize(1024), coalesceMode(coalesceModes::OFF), renderMode(renderModes::CONTINUOUS), targetFPS(0.0), performanceOverlay(false), headless(false) {
         }
     };
 
     class Window {
     private:
         friend class callbackManagers;
+        friend bool init();
         friend void deinit();
         friend void processEvents();
+        friend void beginEventFrame();
+        friend bool captureInputEvent(const Window* window, const windowEvent& event);
+        friend void renderThreadLoop();
+        friend bool startRenderThread();
+        friend void stopRenderThread();
+        friend void attachRenderThread(Window* window);
+        friend void detachRenderThread(Window* window);
+        friend void screenshotLoop();
 
         static inline int m_instances;
         static inline std::vector<Window*> m_instancesList;
+        static inline uint32_t m_createdWindows;
+        static inline std::atomic<bool> m_wakeupPosted;
+        // Counts glfw window callbacks, lets the event loop tell a real event from an expired wait.
+        static inline uint64_t m_glfwEventCount;
+        static inline std::chrono::duration<double> m_eventTime;
+        static inline GLFWwindow* m_shareWindow;
+        static inline GladGLContext* m_shareContext;
+        static inline thread_local Window* m_currentWindow;
         GLFWwindow* m_window = nullptr;
         GladGLContext* m_openglContext;
         bool m_closed;
         bool m_frame;
         windowData m_data;
-        std::vector<windowEvent> m_eventQueue;
+        eventQueue m_eventQueue;
+        // Pushes rejected by a full queue, counted by the producers and reported once per "processEvents()" by the main thread.
+        std::atomic<uint64_t> m_droppedEvents = 0;
+        std::vector<windowEvent> m_eventBatch;
+        // The batch handed to the callbacks, events they cause meanwhile go to "m_eventBatch" for the next one.
+        std::vector<windowEvent> m_dispatchingBatch;
+        std::vector<eventSample> m_eventSamples;
+        // Pending coalesced events, at most one per coalescable type (scroll, cursor position, window position and size).
+        std::array<windowEvent, 4> m_coalescedEvents;
+        size_t m_coalescedCount;
+        std::array<std::vector<eventListener>, eventTypeCount> m_listeners;
+        std::vector<std::pair<eventTypes, eventListener>> m_pendingListeners;
+        size_t m_nextListenerId = 1;
+        int m_listenerDepth = 0;
+        std::list<dropStorage> m_dropStorage;
+        std::mutex m_dropStorageMutex;
         ImGuiContext* m_ImContext;
         ImGuiIO* m_IO;
+        imguiRenderer m_imguiRenderer;
+        bool m_dirty = true;
+        bool m_frameSkipped = false;
+        bool m_scheduled = false;
+        bool m_presentPending = false;
+        bool m_threaded = false;
+        int m_swapInterval = -2;
+        std::chrono::duration<double> m_swapTime{0.0};
+        uint64_t m_drawDataHash = 0;
+        framePacer m_pacer;
+        frameStats m_frameStats;
+        gpuProfiler m_gpuProfiler;
+        headlessSurface* m_headless = nullptr;
+        frameCapture m_capture;
+        frameCapture m_screenshotCapture;
+        std::vector<pendingScreenshot> m_screenshots;
+        std::mutex m_screenshotMutex;
+        uint64_t m_nextScreenshotId = 1;
+        uint64_t m_frameCount = 0;
+        bool m_headlessShouldClose = false;
+        bool m_applyingRequest = false;
+        // Position in creation order since "init()", unlike the index in "m_instancesList" it doesn't shift when older windows are destroyed.
+        uint32_t m_creationId = 0;
+        std::array<uint32_t, eventTypeCount> m_eventCounts{};
+        size_t m_queueDepth = 0;
+        uint64_t m_allocationMark = 0;
+        bool m_overlayEnabledProfiler = false;
+        std::vector<gpuScopeResult> m_overlayScopes;
+        std::chrono::steady_clock::time_point m_lastFrameStart;
+        std::chrono::duration<double> m_frameInterval;
 
         std::chrono::steady_clock::time_point newframe;
         std::chrono::steady_clock::time_point endframe;
         std::chrono::duration<double> deltaTime;
 
         void createWindowIntern(const std::string& title, int width, int height, int xpos, int ypos, ImGuiConfigFlags ImGuiFlags);
+        void createHeadlessIntern(const std::string& title, int width, int height, ImGuiConfigFlags ImGuiFlags);
+        void makeContextCurrent();
+        bool renderFrame();
+        void beginGpuFrame();
+        void drawFrame(ImDrawData* drawData, int width, int height, const float clearColor[4], uint64_t frame);
+        std::chrono::duration<double> presentFrame(int swapInterval);
+        void finishFrame();
+        const void* getShareGroup() const;
+        bool canRenderThreaded() const;
+        GladGLContext* beginResourceUpload();
+        void endResourceUpload(Window* previous, GladGLContext* openglContext);
+        GLuint createTextureIntern(int width, int height, const unsigned char* pixels);
+        void feedHeadlessInput(const windowEvent& event);
+        void dispatchEvent(const windowEvent& event);
+        void deliverEvent(const windowEvent& event);
+        void flushCoalescedEvent();
+        void invokeListeners(const windowEvent& event);
+        size_t addListenerIntern(eventTypes type, eventListener listener);
+        void drainEventQueue(size_t count);
+        bool postEvent(const windowEvent& event);
+        void storeDropPaths(windowEvent& event);
+        void releaseDropStorage(const windowEvent& event);
+        void drawPerformanceOverlay();
+        static void screenshotCallback(Window* window, const capturedFrame& frame, void* userData);
     public:
         /// @brief Window object empty default constuctor, can be used later with "createWindow()" method.
         Window();
@@ -135,14 +263,39 @@ namespace PNT {
         /// @brief Hides the window, returns the sdl error code (0 is success).
         void endFrame();
 
+        /// @brief Ends the frame of every window that started one, all of them are rendered first and then presented so only the last vsynced window waits for vblank (the others swap with an interval of 0).
+        static void renderAll();
+
         /// @brief Sets the event callback of the window that will be call every time there is an event.
         /// @param newEventCallback The desired function pointer for the event callback with signature "PNT::Window*, PNT::windowEvent" (use nullptr to clear callback).
         void setEventCallback(void(*newEventCallback)(Window*, windowEvent));
 
-        /// @brief Pushes an event to the event stack.
-        /// @param event The desired event to push, you can create events with the numerous "create...Event(...);" functions.
-        /// @warning glfw has no event queue manipulation that I know of, so all custom events push by this function will be proccesed before glfw events.
-        void pushEvent(windowEvent event);
+        /// @brief Sets the batched event callback of the window, while set all events (glfw and pushed) are queued and handed over once per "processEvents()" call in the order they arrived (events caused by the callback itself come with the next call).
+        /// @param newEventBatchCallback The desired function pointer for the batched event callback with signature "PNT::Window*, std::span<const PNT::windowEvent>" (use nullptr to go back to the per event callback).
+        void setEventBatchCallback(void(*newEventBatchCallback)(Window*, std::span<const windowEvent>));
+
+        /// @brief Pushes an event to the event queue, safe to call from any thread (a blocked event loop is woken up).
+        /// @param event The desired event to push, you can create events with the numerous "create...Event(...);" functions (drop event paths are copied).
+        /// @return True if the event was queued and false if the queue is full (see "windowData::eventQueueSize").
+        /// @warning glfw has no event queue manipulation that I know of, so unless a batched event callback is set all custom events push by this function will be proccesed before glfw events.
+        bool pushEvent(windowEvent event);
+
+        /// @brief Adds a listener for one event type, any number of listeners can be added per window and event types without listeners cost nothing.
+        /// @tparam type The desired event type to listen to.
+        /// @param function Any callable with signature "PNT::Window*, const payload&" where payload is the matching event struct ("bool" for "ICONIFY"), stored inline without allocating.
+        /// @return An id that can be passed to "removeListener()".
+        template<eventTypes type, typename callable>
+        size_t addListener(callable&& function) {
+            return addListenerIntern(type, eventListener::create<type>(m_nextListenerId++, std::forward<callable>(function)));
+        }
+
+        /// @brief Removes a listener added with "addListener()", safe to call from inside a listener.
+        /// @param id The id returned by "addListener()".
+        void removeListener(size_t id);
+
+        /// @brief Sets how consecutive cursor position, window position, window size and scroll events are merged before reaching the event callback.
+        /// @param coalesceMode The desired coalesce mode, "LATEST" delivers the latest position/size or the summed scroll once per "processEvents()" call and "LATEST_WITH_HISTORY" also keeps every sample (see "getEventSamples()").
+        void setCoalesceMode(coalesceModes coalesceMode);
 
         /// @brief Sets a pointer for the window that can be retrived later.
         /// @param pointer The desired user defined pointer for the window.
@@ -189,6 +342,68 @@ namespace PNT {
         /// @param vsyncMode The desired vsync mode for the windowof type "vsyncModes".
         void setVsyncMode(vsyncModes vsyncMode);
 
+        /// @brief Caps the frame rate of the window, "endFrame()" sleeps and then spins until the next frame is due.
+        /// @param fps The desired frames per second (0 for uncapped).
+        void setTargetFPS(double fps);
+
+        /// @brief Sets the render mode for the window.
+        /// @param renderMode "CONTINUOUS" renders and swaps every frame, "REACTIVE" skips the render and swap of frames whose imgui draw data did not change unless the window was marked dirty.
+        void setRenderMode(renderModes renderMode);
+
+        /// @brief Forces the next frame to be rendered in "renderModes::REACTIVE", call this after drawing anything imgui doesn't know about.
+        void markDirty();
+
+        /// @brief Checks if the last "endFrame()" skipped rendering because nothing changed.
+        /// @return True if the last frame was skipped.
+        bool getFrameSkipped() const;
+
+        /// @brief Sets the function that receives captured frames, frames are read back asynchronously and delivered by a later "startFrame()" (by the render thread if it runs).
+        /// Returns only once the old callback is no longer running, so its user data can be freed right after.
+        /// @param callback The desired callback, the pixels are only valid during the call.
+        /// @param userData The desired pointer passed to the callback.
+        void setCaptureCallback(void(*callback)(Window*, const capturedFrame&, void*), void* userData = nullptr);
+
+        /// @brief Captures every rendered frame until disabled.
+        /// @param continuous The desired state.
+        void setContinuousCapture(bool continuous);
+
+        /// @brief Captures the next rendered frame.
+        void requestCapture();
+
+        /// @brief Creates a texture usable by every window sharing objects with this one (all windowed ones, or all headless ones).
+        /// @param width The texture width.
+        /// @param height The texture height.
+        /// @param pixels Tightly packed RGBA8 rows, top row first, or nullptr to leave the texture uninitialized.
+        /// @return A handle, the texture is deleted once every copy of it is gone.
+        gpuResource createTexture(int width, int height, const unsigned char* pixels);
+
+        /// @brief Loads an image into a texture, images already loaded by any window of the share group are returned without touching the gpu.
+        /// @param path The desired image path.
+        /// @return A handle, or an empty handle if the image couldn't be loaded.
+        gpuResource loadTexture(const std::string& path);
+
+        /// @brief Creates a buffer usable by every window sharing objects with this one.
+        /// @param size The buffer size in bytes.
+        /// @param data The initial contents, or nullptr to leave the buffer uninitialized.
+        /// @param usage The desired usage hint.
+        /// @return A handle, the buffer is deleted once every copy of it is gone.
+        gpuResource createBuffer(GLsizeiptr size, const void* data, GLenum usage = GL_STATIC_DRAW);
+
+        /// @brief Compiles and links a shader program usable by every window sharing objects with this one.
+        /// @param vertexSource The vertex shader source.
+        /// @param fragmentSource The fragment shader source.
+        /// @return A handle, or an empty handle if compiling or linking failed (the log is written to the logger).
+        gpuResource createProgram(const std::string& vertexSource, const std::string& fragmentSource);
+
+        /// @brief Saves the next rendered frame as a PNG without stalling, the readback is asynchronous and the encoding runs on a worker thread.
+        /// @param path The desired path of the PNG file.
+        /// @return An id reported back by a "SCREENSHOT" event once the file was written (or failed to).
+        uint64_t requestScreenshot(const std::string& path);
+
+        /// @brief Shows or hides the performance overlay, drawn by "endFrame()" with frame time graphs, cpu and gpu timings, event counts, queue depth and the process wide allocation count since the overlay was last drawn.
+        /// @param shown The desired state, showing it enables the gpu profiler until it is hidden again.
+        void setPerformanceOverlay(bool shown);
+
         /// @brief Sets the opengl clear color for the window.
         /// @param red The desired red channel.
         /// @param green The desired green channel.
@@ -205,10 +420,39 @@ namespace PNT {
         /// @param denominator The desired aspect ratio denominator (-1 for anything).
         void setAspectRatio(int numerator, int denominator);
 
-        /// @brief Gets the time to calculate the last frame.
+        /// @brief Gets the time to calculate the last frame (see "getFrameStats()" for the full picture).
         /// @return The time in nanoseconds between the last newframe and endframe pair.
         std::chrono::duration<double> getDeltaTime() const;
 
+        /// @brief Gets every coalesced event sample recorded during the last "processEvents()" call (only filled with "coalesceModes::LATEST_WITH_HISTORY").
+        /// @return A view of the timestamped samples in arrival order, valid until the next "processEvents()" call.
+        std::span<const eventSample> getEventSamples() const;
+
+        /// @brief Sets how many frames the frame statistics keep, all collected samples are discarded.
+        /// @param frames The desired size of the sliding window (the default is 240).
+        void setFrameStatsCapacity(size_t frames);
+
+        /// @brief Gets the frame statistics of the window, one sample is added by every "endFrame()".
+        /// @return The frame-to-frame, cpu (startFrame to endFrame without the swap), swap and event processing timings over a sliding window.
+        /// @warning The event processing time is the last "processEvents()" call, shared by all windows, and includes the time spent blocked in "eventLoopModes::WAIT".
+        const frameStats& getFrameStats() const;
+
+        /// @brief Gets the gpu profiler of the window, it is disabled by default and measures the "Clear" and "ImGui" scopes of every frame once enabled.
+        /// @return The profiler, custom scopes can be added between "startFrame()" and "endFrame()" with the window's context current.
+        gpuProfiler& getGpuProfiler();
+
+        /// @brief Gets the number of captures dropped because the gpu or the capture callback fell behind.
+        /// @return The dropped capture count.
+        uint64_t getDroppedCaptures() const;
+
+        /// @brief Checks if the performance overlay is shown.
+        /// @return True if "endFrame()" draws the overlay.
+        bool getPerformanceOverlay() const;
+
+        /// @brief Gets how much time the last frame had left before its deadline when "setTargetFPS()" is used.
+        /// @return The slack of the last frame, negative if it was late.
+        std::chrono::duration<double> getFrameSlack() const;
+
         /// @brief Retrives the user pointer set by the "setUserPointer()" method.
         /// @return A raw pointer set by the user.
         void* getUserPointer() const;
@@ -258,7 +502,15 @@ namespace PNT {
         bool shouldClose() const;
 
         /// @brief Gets the glfw window.
-        /// @return A pointer to the internal glfw window (BE CAREFUL).
+        /// @return A pointer to the internal glfw window (BE CAREFUL), nullptr for headless windows.
         const GLFWwindow* getGLFWWindow() const;
+
+        /// @brief Checks if the window renders offscreen without a display server ("windowData::headless").
+        /// @return True for headless windows.
+        bool getHeadless() const;
+
+        /// @brief Gets the framebuffer the window renders into, it is bound between "startFrame()" and "endFrame()".
+        /// @return The framebuffer object of a headless window, 0 (the default framebuffer) otherwise.
+        GLuint getFramebuffer() const;
     };
 }
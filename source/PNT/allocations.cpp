@@ -0,0 +1,78 @@
+#include <PNT/allocations.hpp>
+
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+namespace PNT {
+    static std::atomic<uint64_t> allocationCount = 0;
+
+    // Allocation tracking definitions.
+
+    bool getAllocationTracking() {
+#ifdef PNT_TRACK_ALLOCATIONS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    uint64_t getAllocationCount() {
+        return allocationCount.load(std::memory_order_relaxed);
+    }
+
+#ifdef PNT_TRACK_ALLOCATIONS
+    static void* countedAllocate(size_t size) noexcept {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        return std::malloc(size ? size : 1);
+    }
+#endif
+}
+
+#ifdef PNT_TRACK_ALLOCATIONS
+// Replacing the global operators is the only way to see allocations made by imgui, spdlog and user code alike,
+// the over-aligned overloads are left alone since they pair with their own default delete.
+void* operator new(size_t size) {
+    void* pointer = PNT::countedAllocate(size);
+    if(pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    return PNT::countedAllocate(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    return PNT::countedAllocate(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept {
+    std::free(pointer);
+}
+#endif
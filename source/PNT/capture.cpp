@@ -0,0 +1,128 @@
+#include <PNT/capture.hpp>
+
+#include <spdlog/spdlog.h>
+
+namespace PNT {
+    extern std::shared_ptr<spdlog::logger> logger;
+
+    // Frame capture definitions.
+
+    frameCapture::frameCapture() : m_openglContext(nullptr), m_slots(), m_oldest(0), m_pending(0), m_continuous(false), m_requested(false), m_dropped(0), m_callback(nullptr), m_userData(nullptr) {
+    }
+
+    void frameCapture::init(GladGLContext* openglContext) {
+        m_openglContext = openglContext;
+    }
+
+    void frameCapture::shutdown() {
+        if(m_openglContext == nullptr) {
+            return;
+        }
+
+        for(captureSlot& slot : m_slots) {
+            if(slot.fence != nullptr) {
+                m_openglContext->DeleteSync(slot.fence);
+            }
+            if(slot.buffer != 0) {
+                m_openglContext->DeleteBuffers(1, &slot.buffer);
+            }
+            slot = captureSlot{};
+        }
+        m_oldest = 0;
+        m_pending = 0;
+        m_openglContext = nullptr;
+    }
+
+    void frameCapture::setCallback(void(*callback)(Window*, const capturedFrame&, void*), void* userData) {
+        std::lock_guard<std::mutex> lock(m_callbackMutex);
+        m_callback = callback;
+        m_userData = userData;
+    }
+
+    void frameCapture::setContinuous(bool continuous) {
+        m_continuous = continuous;
+    }
+
+    void frameCapture::request() {
+        m_requested = true;
+    }
+
+    bool frameCapture::wanted() const {
+        return m_continuous || m_requested;
+    }
+
+    uint64_t frameCapture::getDropped() const {
+        return m_dropped;
+    }
+
+    bool frameCapture::capture(int width, int height, uint64_t frame) {
+        if(m_openglContext == nullptr || width <= 0 || height <= 0) {
+            return false;
+        }
+        if(!m_openglContext->VERSION_3_2) {
+            logger.get()->warn("[PNT]Frame capture needs OpenGL 3.2 fences");
+            m_continuous = false;
+            m_requested = false;
+            return false;
+        }
+        // A full ring means the gpu or the callback is falling behind, dropping the frame is better than stalling on it.
+        // A requested capture stays requested so it is retried next frame.
+        if(m_pending == ringSize) {
+            m_dropped++;
+            return false;
+        }
+        m_requested = false;
+
+        captureSlot& slot = m_slots[(m_oldest + m_pending) % ringSize];
+        size_t size = (size_t)width * (size_t)height * 4;
+        if(slot.buffer == 0) {
+            m_openglContext->GenBuffers(1, &slot.buffer);
+        }
+        m_openglContext->BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        if(slot.size != size) {
+            m_openglContext->BufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)size, nullptr, GL_STREAM_READ);
+            slot.size = size;
+        }
+
+        GLint packAlignment;
+        m_openglContext->GetIntegerv(GL_PACK_ALIGNMENT, &packAlignment);
+        m_openglContext->PixelStorei(GL_PACK_ALIGNMENT, 1);
+        m_openglContext->ReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        m_openglContext->PixelStorei(GL_PACK_ALIGNMENT, packAlignment);
+        m_openglContext->BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        slot.fence = m_openglContext->FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.width = width;
+        slot.height = height;
+        slot.frame = frame;
+        m_pending++;
+        return true;
+    }
+
+    void frameCapture::poll(Window* window) {
+        while(m_pending) {
+            captureSlot& slot = m_slots[m_oldest];
+            // A zero timeout only asks, the flush makes sure the fence actually reaches the gpu.
+            GLenum status = m_openglContext->ClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            if(status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) {
+                return;
+            }
+            m_openglContext->DeleteSync(slot.fence);
+            slot.fence = nullptr;
+
+            std::lock_guard<std::mutex> lock(m_callbackMutex);
+            if(m_callback != nullptr) {
+                m_openglContext->BindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+                const unsigned char* pixels = static_cast<const unsigned char*>(m_openglContext->MapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)slot.size, GL_MAP_READ_BIT));
+                if(pixels != nullptr) {
+                    m_callback(window, capturedFrame{slot.frame, slot.width, slot.height, std::span<const unsigned char>(pixels, slot.size)}, m_userData);
+                    m_openglContext->UnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                }
+                m_openglContext->BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            }
+
+            m_oldest = (m_oldest + 1) % ringSize;
+            m_pending--;
+        }
+    }
+}
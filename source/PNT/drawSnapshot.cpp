@@ -0,0 +1,86 @@
+#include <PNT/drawSnapshot.hpp>
+
+#include <string.h>
+
+namespace PNT {
+    // "ImVector::operator=()" frees the old buffer first, resizing keeps it when it's big enough.
+    template<typename T>
+    static void copyVector(ImVector<T>& destination, const ImVector<T>& source) {
+        destination.resize(source.Size);
+        if(source.Size > 0) {
+            memcpy(destination.Data, source.Data, (size_t)source.Size * sizeof(T));
+        }
+    }
+
+    template<typename T>
+    static size_t vectorCapacity(const ImVector<T>& vector) {
+        return (size_t)vector.Capacity * sizeof(T);
+    }
+
+    // Draw data snapshot definitions.
+
+    drawDataSnapshot::drawDataSnapshot() {
+        m_drawData.Valid = false;
+        m_drawData.CmdListsCount = 0;
+        m_drawData.TotalIdxCount = 0;
+        m_drawData.TotalVtxCount = 0;
+        m_drawData.DisplayPos = ImVec2(0.0f, 0.0f);
+        m_drawData.DisplaySize = ImVec2(0.0f, 0.0f);
+        m_drawData.FramebufferScale = ImVec2(1.0f, 1.0f);
+        m_drawData.OwnerViewport = nullptr;
+    }
+
+    drawDataSnapshot::~drawDataSnapshot() {
+        clear();
+    }
+
+    void drawDataSnapshot::copy(const ImDrawData* drawData) {
+        // The lists only carry output buffers, they are never drawn into so they need no shared data.
+        while(m_lists.Size < drawData->CmdListsCount) {
+            m_lists.push_back(IM_NEW(ImDrawList)(nullptr));
+        }
+
+        m_drawData.CmdLists.resize(drawData->CmdListsCount);
+        for(int i = 0; i < drawData->CmdListsCount; i++) {
+            const ImDrawList* source = drawData->CmdLists[i];
+            ImDrawList* list = m_lists[i];
+            copyVector(list->CmdBuffer, source->CmdBuffer);
+            copyVector(list->IdxBuffer, source->IdxBuffer);
+            copyVector(list->VtxBuffer, source->VtxBuffer);
+            list->Flags = source->Flags;
+            m_drawData.CmdLists[i] = list;
+        }
+        m_drawData.Valid = drawData->Valid;
+        m_drawData.CmdListsCount = drawData->CmdListsCount;
+        m_drawData.TotalIdxCount = drawData->TotalIdxCount;
+        m_drawData.TotalVtxCount = drawData->TotalVtxCount;
+        m_drawData.DisplayPos = drawData->DisplayPos;
+        m_drawData.DisplaySize = drawData->DisplaySize;
+        m_drawData.FramebufferScale = drawData->FramebufferScale;
+        m_drawData.OwnerViewport = drawData->OwnerViewport;
+    }
+
+    ImDrawData* drawDataSnapshot::get() {
+        return &m_drawData;
+    }
+
+    void drawDataSnapshot::clear() {
+        for(ImDrawList* list : m_lists) {
+            IM_DELETE(list);
+        }
+        m_lists.clear();
+        m_drawData.CmdLists.clear();
+        m_drawData.Valid = false;
+        m_drawData.CmdListsCount = 0;
+        m_drawData.TotalIdxCount = 0;
+        m_drawData.TotalVtxCount = 0;
+    }
+
+    size_t drawDataSnapshot::getCapacity() const {
+        size_t capacity = 0;
+        for(const ImDrawList* list : m_lists) {
+            capacity += vectorCapacity(list->CmdBuffer) + vectorCapacity(list->IdxBuffer) + vectorCapacity(list->VtxBuffer);
+        }
+        return capacity;
+    }
+}
@@ -2,26 +2,168 @@
 
 #include <cstring>
 #include <string>
+#include <limits>
+#include <chrono>
+#include <algorithm>
 #include <GLFW/glfw3.h>
+#include <spdlog/spdlog.h>
 #include <PNT/window.hpp>
+#include <PNT/record.hpp>
+#include <PNT/trace.hpp>
 
 namespace PNT {
+    extern std::shared_ptr<spdlog::logger> logger;
+
+    static eventLoopModes eventLoopMode = eventLoopModes::POLL;
+    static double eventWaitTimeout = 0.0;
+    static int eventSettleFrames = 3;
+    static int framesToRun = 0;
+    static double wakeupTime = std::numeric_limits<double>::infinity();
+
+    // Blocks in glfw until something happens, or polls if there is already work to do.
+    static void waitForEvents(bool workPending) {
+        if(eventLoopMode == eventLoopModes::POLL || workPending || framesToRun > 0) {
+            framesToRun = std::max(framesToRun - 1, 0);
+            glfwPollEvents();
+            return;
+        }
+
+        double now = glfwGetTime();
+        double timeout = wakeupTime - now;
+        if(eventWaitTimeout > 0.0) {
+            timeout = std::min(timeout, eventWaitTimeout);
+        }
+
+        if(timeout <= 0.0) {
+            glfwPollEvents();
+        } else if(timeout == std::numeric_limits<double>::infinity()) {
+            glfwWaitEvents();
+        } else {
+            glfwWaitEventsTimeout(timeout);
+        }
+
+        if(wakeupTime <= glfwGetTime()) {
+            wakeupTime = std::numeric_limits<double>::infinity();
+        }
+    }
+
     // Event definitions.
 
+    void setEventLoopMode(eventLoopModes mode) {
+        eventLoopMode = mode;
+    }
+
+    eventLoopModes getEventLoopMode() {
+        return eventLoopMode;
+    }
+
+    void setEventWaitTimeout(double seconds) {
+        eventWaitTimeout = seconds;
+    }
+
+    void setEventSettleFrames(int frames) {
+        eventSettleFrames = std::max(frames, 0);
+    }
+
+    void requestWakeup(double seconds) {
+        wakeupTime = std::min(wakeupTime, glfwGetTime() + seconds);
+    }
+
+    void requestFrames(int frames) {
+        framesToRun = std::max(framesToRun, frames);
+    }
+
     void processEvents() {
+        markTraceFrame();
+        traceZone zone("processEvents");
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        Window::m_wakeupPosted.store(false, std::memory_order_release);
+        beginEventFrame();
+
+        for(Window* window : Window::m_instancesList) {
+            window->m_eventSamples.clear();
+            window->m_eventCounts.fill(0);
+            window->m_queueDepth = window->m_eventQueue.size();
+            uint64_t dropped = window->m_droppedEvents.exchange(0, std::memory_order_relaxed);
+            if(dropped) {
+                logger.get()->warn("[PNT]Event queue full, dropped {} pushed event(s) for window \"{}\"", dropped, window->m_data.title);
+            }
+            if(window->m_data.eventBatchCallback != nullptr) {
+                continue;
+            }
+
+            // Only drain what was queued up to now so busy producers can't starve the frame.
+            size_t pending = window->m_eventQueue.size();
+            windowEvent event;
+            while(pending-- && window->m_eventQueue.pop(event)) {
+                traceZone eventZone(event.getTypename());
+                if(window->m_headless != nullptr) {
+                    window->feedHeadlessInput(event);
+                }
+                if(window->m_data.eventCallback != nullptr) {
+                    window->m_data.eventCallback(window, event);
+                }
+                window->invokeListeners(event);
+                window->releaseDropStorage(event);
+            }
+        }
+
+        // Replays and queued events need frames of their own, so never block while they are around.
+        bool workPending = isReplaying();
         for(Window* window : Window::m_instancesList) {
-            while(window->m_eventQueue.size()) {
-                window->m_data.eventCallback(window, window->m_eventQueue.back());
-                window->m_eventQueue.pop_back();
+            workPending = workPending || window->m_eventQueue.size() || window->m_eventBatch.size();
+        }
+        uint64_t glfwEvents = Window::m_glfwEventCount;
+        {
+            traceZone waitZone("glfwPollEvents");
+            waitForEvents(workPending);
+        }
+        // An event probably changes the ui, give imgui a few frames to react before blocking again.
+        // An expired timeout changes nothing, so an idle app only renders the one frame it woke up for.
+        if(Window::m_glfwEventCount != glfwEvents || Window::m_wakeupPosted.load(std::memory_order_acquire)) {
+            framesToRun = std::max(framesToRun, eventSettleFrames);
+        }
+
+        // Coalesced events are held back until the poll is over so each one reaches the callbacks once per call.
+        for(Window* window : Window::m_instancesList) {
+            window->flushCoalescedEvent();
+        }
+
+        // Batched windows queued their glfw events behind the pushed ones, so everything comes out in arrival order.
+        for(Window* window : Window::m_instancesList) {
+            if(window->m_data.eventBatchCallback == nullptr) {
+                continue;
             }
+
+            window->m_queueDepth = std::max(window->m_queueDepth, window->m_eventQueue.size());
+            window->drainEventQueue(window->m_eventQueue.size());
+            // A callback or listener can trigger glfw callbacks right away (resizing on win32) that append to "m_eventBatch", so the batch is moved out before calling them.
+            // Swapping keeps both vectors' capacity, the batch doesn't allocate once it saw the biggest one.
+            std::vector<windowEvent>& batch = window->m_dispatchingBatch;
+            batch.swap(window->m_eventBatch);
+            if(window->m_headless != nullptr) {
+                for(const windowEvent& event : batch) {
+                    window->feedHeadlessInput(event);
+                }
+            }
+            if(batch.size()) {
+                traceZone batchZone("Event batch");
+                window->m_data.eventBatchCallback(window, batch);
+            }
+            for(const windowEvent& event : batch) {
+                window->invokeListeners(event);
+                window->releaseDropStorage(event);
+            }
+            batch.clear();
         }
-        glfwPollEvents();
+
+        Window::m_eventTime = std::chrono::steady_clock::now() - start;
     }
 
     // Event creation function definitions.
 
     windowEvent createKeyEvent(int key, int scancode, int action, int mods) {
-        windowEvent event;
+        windowEvent event{};
 
         event.type = eventTypes::KEYBOARD;
         event.keyboard.key = key;
@@ -33,7 +175,7 @@ namespace PNT {
     }
 
     windowEvent createCharEvent(unsigned int codepoint) {
-        windowEvent event;
+        windowEvent event{};
 
         event.type = eventTypes::CHAR;
         event.character.codepoint = codepoint;
@@ -42,18 +184,17 @@ namespace PNT {
     }
 
     windowEvent createDropEvent(int pathCount, const char* paths[]) {
-        windowEvent event;
+        windowEvent event{};
 
         event.type = eventTypes::DROP;
-        for(int i = 0; i < pathCount; i++) {
-            event.dropFiles.paths.emplace_back(paths[i]);
-        }
+        event.dropFiles.pathCount = pathCount;
+        event.dropFiles.paths = paths;
 
         return event;
     }
 
     windowEvent createScrollEvent(double xoffset, double yoffset) {
-        windowEvent event;
+        windowEvent event{};
 
         event.type = eventTypes::SCROLL;
         event.scroll.xoffset = xoffset;
@@ -63,7 +204,7 @@ namespace PNT {
     }
 
     windowEvent createCursorposEvent(double xpos, double ypos) {
-        windowEvent event;
+        windowEvent event{};
 
         event.type = eventTypes::CURSORPOS;
         event.cursorpos.xpos = xpos;
@@ -73,7 +214,7 @@ namespace PNT {
     }
 
     windowEvent createWindowposEvent(int xpos, int ypos) {
-        windowEvent event;
+        windowEvent event{};
 
         event.type = eventTypes::WINDOWPOS;
         event.windowpos.xpos = xpos;
@@ -83,7 +224,7 @@ namespace PNT {
     }
 
     windowEvent createWindowsizeEvent(int width, int height) {
-        windowEvent event;
+        windowEvent event{};
 
         event.type = eventTypes::WINDOWSIZE;
         event.windowsize.width = width;
@@ -93,7 +234,7 @@ namespace PNT {
     }
 
     windowEvent createCursorEnterEvent(int entered) {
-        windowEvent event;
+        windowEvent event{};
 
         event.type = eventTypes::CURSORENTER;
         event.cursorenter.entered = entered;
@@ -102,7 +243,7 @@ namespace PNT {
     }
 
     windowEvent createMousebuttonEvent(int button, int action, int mods) {
-        windowEvent event;
+        windowEvent event{};
 
         event.type = eventTypes::MOUSEBUTTON;
         event.mousebutton.button = button;
@@ -113,7 +254,7 @@ namespace PNT {
     }
 
     windowEvent createWindowFocusEvent(int focused) {
-        windowEvent event;
+        windowEvent event{};
 
         event.type = eventTypes::WINDOWFOCUS;
         event.windowfocus.focused = focused;
@@ -122,14 +263,25 @@ namespace PNT {
     }
 
     windowEvent createIconifyEvent(bool iconified) {
-        windowEvent event;
+        windowEvent event{};
 
         event.type = eventTypes::ICONIFY;
         event.iconified = iconified;
 
         return event;
     }
-    const char *windowEvent::getTypename() {
+
+    windowEvent createScreenshotEvent(uint64_t id, bool succeeded) {
+        windowEvent event{};
+
+        event.type = eventTypes::SCREENSHOT;
+        event.screenshot.id = id;
+        event.screenshot.succeeded = succeeded;
+
+        return event;
+    }
+
+    const char* windowEvent::getTypename() const {
         switch(type) {
             case eventTypes::KEYBOARD:
                 return "Key press";
@@ -164,6 +316,9 @@ namespace PNT {
             case eventTypes::ICONIFY:
                 return "Minimized/Maximized";
                 break;
+            case eventTypes::SCREENSHOT:
+                return "Screenshot";
+                break;
             default:
                 return "Unregistered event name";
                 break;
@@ -0,0 +1,89 @@
+#include <PNT/eventQueue.hpp>
+
+#include <bit>
+#include <PNT/event.hpp>
+
+namespace PNT {
+    // Every cell carries a sequence number that tells producers and the consumer whose turn it is.
+    struct eventQueue::cell {
+        std::atomic<size_t> sequence;
+        windowEvent event;
+    };
+
+    // Event queue definitions.
+
+    eventQueue::eventQueue() : m_cells(nullptr), m_mask(0), m_head(0), m_tail(0) {
+    }
+
+    eventQueue::~eventQueue() {
+    }
+
+    void eventQueue::allocate(size_t capacity) {
+        capacity = std::bit_ceil(capacity < 2 ? 2 : capacity);
+
+        m_cells = std::make_unique<cell[]>(capacity);
+        for(size_t i = 0; i < capacity; i++) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        m_mask = capacity - 1;
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail = 0;
+    }
+
+    void eventQueue::free() {
+        m_cells.reset();
+        m_mask = 0;
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail = 0;
+    }
+
+    bool eventQueue::push(const windowEvent& event) {
+        if(m_cells == nullptr) {
+            return false;
+        }
+
+        size_t position = m_head.load(std::memory_order_relaxed);
+        while(true) {
+            cell& target = m_cells[position & m_mask];
+            size_t sequence = target.sequence.load(std::memory_order_acquire);
+            ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)position;
+
+            if(difference == 0) {
+                if(m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    target.event = event;
+                    target.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if(difference < 0) {
+                return false;
+            } else {
+                position = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool eventQueue::pop(windowEvent& event) {
+        if(m_cells == nullptr) {
+            return false;
+        }
+
+        cell& target = m_cells[m_tail & m_mask];
+        if(target.sequence.load(std::memory_order_acquire) != m_tail + 1) {
+            return false;
+        }
+
+        event = target.event;
+        target.sequence.store(m_tail + m_mask + 1, std::memory_order_release);
+        m_tail++;
+        return true;
+    }
+
+    size_t eventQueue::capacity() const {
+        return m_cells == nullptr ? 0 : m_mask + 1;
+    }
+
+    size_t eventQueue::size() const {
+        size_t head = m_head.load(std::memory_order_acquire);
+        return head > m_tail ? head - m_tail : 0;
+    }
+}
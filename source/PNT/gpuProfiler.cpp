@@ -0,0 +1,153 @@
+#include <PNT/gpuProfiler.hpp>
+
+#include <spdlog/spdlog.h>
+
+namespace PNT {
+    extern std::shared_ptr<spdlog::logger> logger;
+
+    // GPU profiler definitions.
+
+    gpuProfiler::gpuProfiler() : m_openglContext(nullptr), m_wantEnabled(false), m_enabled(false), m_inFrame(false), m_frames(), m_frameIndex(0), m_stack(), m_results() {
+        m_stack.reserve(maxScopes);
+    }
+
+    gpuProfiler::~gpuProfiler() {
+    }
+
+    void gpuProfiler::init(GladGLContext* openglContext) {
+        m_openglContext = openglContext;
+    }
+
+    void gpuProfiler::shutdown() {
+        m_wantEnabled = false;
+        applyEnabled(false);
+        m_openglContext = nullptr;
+    }
+
+    void gpuProfiler::setEnabled(bool enabled) {
+        m_wantEnabled = enabled;
+    }
+
+    void gpuProfiler::applyEnabled(bool enabled) {
+        if(enabled == m_enabled || m_openglContext == nullptr) {
+            return;
+        }
+        if(enabled && !m_openglContext->VERSION_3_3) {
+            logger.get()->warn("[PNT]GPU profiling needs OpenGL 3.3 timer queries");
+            m_wantEnabled = false;
+            return;
+        }
+
+        for(frameQueries& frame : m_frames) {
+            if(enabled) {
+                m_openglContext->GenQueries((GLsizei)frame.queries.size(), frame.queries.data());
+            } else {
+                m_openglContext->DeleteQueries((GLsizei)frame.queries.size(), frame.queries.data());
+            }
+            frame.scopeCount = 0;
+            frame.recorded = false;
+        }
+        m_enabled = enabled;
+        m_inFrame = false;
+        m_stack.clear();
+    }
+
+    bool gpuProfiler::getEnabled() const {
+        return m_wantEnabled;
+    }
+
+    void gpuProfiler::collect(frameQueries& frame) {
+        if(!frame.recorded) {
+            return;
+        }
+        frame.recorded = false;
+
+        // The last query issued in the frame finishes last, if it isn't ready the whole frame is dropped rather than waited on.
+        GLint available = 0;
+        m_openglContext->GetQueryObjectiv(frame.queries[frame.lastQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+        if(!available) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        m_results.clear();
+        for(size_t i = 0; i < frame.scopeCount; i++) {
+            GLuint64 begin = 0, end = 0;
+            m_openglContext->GetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &begin);
+            m_openglContext->GetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+            m_results.emplace_back(gpuScopeResult{frame.scopes[i].name, frame.scopes[i].depth, end > begin ? (double)(end - begin) * 1e-9 : 0.0});
+        }
+    }
+
+    void gpuProfiler::beginFrame() {
+        // Query objects need the context, so changes made from other threads are applied here.
+        if(m_wantEnabled != m_enabled) {
+            applyEnabled(m_wantEnabled);
+        }
+        if(!m_enabled) {
+            return;
+        }
+        if(m_inFrame) {
+            endFrame();
+        }
+
+        m_frameIndex = (m_frameIndex + 1) % frameLatency;
+        collect(m_frames[m_frameIndex]);
+        m_frames[m_frameIndex].scopeCount = 0;
+        m_stack.clear();
+        m_inFrame = true;
+    }
+
+    void gpuProfiler::endFrame() {
+        if(!m_enabled || !m_inFrame) {
+            return;
+        }
+
+        while(m_stack.size()) {
+            endScope();
+        }
+        m_frames[m_frameIndex].recorded = m_frames[m_frameIndex].scopeCount > 0;
+        m_inFrame = false;
+    }
+
+    void gpuProfiler::beginScope(const char* name) {
+        if(!m_enabled || !m_inFrame) {
+            return;
+        }
+
+        frameQueries& frame = m_frames[m_frameIndex];
+        if(frame.scopeCount == maxScopes) {
+            // Keep the stack balanced so the matching endScope() is ignored too.
+            m_stack.emplace_back(maxScopes);
+            return;
+        }
+
+        frame.scopes[frame.scopeCount] = scopeQuery{name, (int)m_stack.size()};
+        m_openglContext->QueryCounter(frame.queries[frame.scopeCount * 2], GL_TIMESTAMP);
+        m_stack.emplace_back(frame.scopeCount++);
+    }
+
+    void gpuProfiler::endScope() {
+        if(!m_enabled || !m_inFrame || m_stack.empty()) {
+            return;
+        }
+
+        size_t scope = m_stack.back();
+        m_stack.pop_back();
+        if(scope < maxScopes) {
+            frameQueries& frame = m_frames[m_frameIndex];
+            frame.lastQuery = scope * 2 + 1;
+            m_openglContext->QueryCounter(frame.queries[frame.lastQuery], GL_TIMESTAMP);
+        }
+    }
+
+    std::vector<gpuScopeResult> gpuProfiler::getResults() const {
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        return m_results;
+    }
+
+    void gpuProfiler::getResults(std::vector<gpuScopeResult>& results) const {
+        std::lock_guard<std::mutex> lock(m_resultsMutex);
+        results.assign(m_results.begin(), m_results.end());
+    }
+}
@@ -0,0 +1,241 @@
+#include <PNT/headless.hpp>
+
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+#ifndef _WIN32
+#include <dlfcn.h>
+#include <glad/egl.h>
+
+// Not part of the generated loader since it only covers core EGL.
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+#endif
+
+namespace PNT {
+    extern std::shared_ptr<spdlog::logger> logger;
+
+#ifndef _WIN32
+    struct headlessSurface {
+        EGLContext context = EGL_NO_CONTEXT;
+        EGLSurface surface = EGL_NO_SURFACE;
+        GladGLContext* openglContext = nullptr;
+        GLuint framebuffer = 0;
+        GLuint colorbuffer = 0;
+        GLuint depthbuffer = 0;
+        int width = 0;
+        int height = 0;
+    };
+
+    // One EGL display is shared by every headless window.
+    static void* eglLibrary = nullptr;
+    static EGLDisplay eglDisplay = EGL_NO_DISPLAY;
+    // Never made current, every headless context shares its objects with it so they outlive any single window.
+    static EGLContext eglShareContext = EGL_NO_CONTEXT;
+    static int headlessSurfaces = 0;
+
+    static GLADapiproc loadEGLFunction(const char* name) {
+        return (GLADapiproc)dlsym(eglLibrary, name);
+    }
+
+    static bool hasExtension(const char* extensions, const char* extension) {
+        if(extensions == nullptr) {
+            return false;
+        }
+        size_t length = std::strlen(extension);
+        for(const char* found = std::strstr(extensions, extension); found != nullptr; found = std::strstr(found + length, extension)) {
+            if((found == extensions || found[-1] == ' ') && (found[length] == ' ' || found[length] == '\0')) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool initEGL() {
+        if(eglDisplay != EGL_NO_DISPLAY) {
+            return true;
+        }
+
+        if(eglLibrary == nullptr) {
+            eglLibrary = dlopen("libEGL.so.1", RTLD_NOW | RTLD_LOCAL);
+        }
+        if(eglLibrary == nullptr) {
+            eglLibrary = dlopen("libEGL.so", RTLD_NOW | RTLD_LOCAL);
+        }
+        if(eglLibrary == nullptr || !gladLoadEGL(EGL_NO_DISPLAY, loadEGLFunction)) {
+            logger.get()->error("[PNT]Failed to load libEGL for headless rendering");
+            return false;
+        }
+
+        // The surfaceless platform needs neither a display server nor a gpu device, which is what CI machines offer.
+        // glad only loads EGL 1.5 entry points once a display is initialized, so this one is looked up directly.
+        EGLDisplay display = EGL_NO_DISPLAY;
+        PFNEGLGETPLATFORMDISPLAYPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYPROC)loadEGLFunction("eglGetPlatformDisplay");
+        if(getPlatformDisplay != nullptr && hasExtension(eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS), "EGL_MESA_platform_surfaceless")) {
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        }
+        if(display == EGL_NO_DISPLAY) {
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+
+        EGLint major, minor;
+        if(display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+            logger.get()->error("[PNT]Failed to initialize an EGL display (error 0x{:X})", eglGetError());
+            return false;
+        }
+        // Reload now that the display knows its real version.
+        gladLoadEGL(display, loadEGLFunction);
+        logger.get()->info("[PNT]Initialized EGL {}.{} ({})", major, minor, eglQueryString(display, EGL_VENDOR));
+
+        eglDisplay = display;
+        return true;
+    }
+
+    static void createFramebuffer(headlessSurface* surface, int width, int height) {
+        GladGLContext* gl = surface->openglContext;
+        gl->GenFramebuffers(1, &surface->framebuffer);
+        gl->GenRenderbuffers(1, &surface->colorbuffer);
+        gl->GenRenderbuffers(1, &surface->depthbuffer);
+        resizeHeadlessSurface(surface, width, height);
+        gl->BindFramebuffer(GL_FRAMEBUFFER, surface->framebuffer);
+        gl->FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, surface->colorbuffer);
+        gl->FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, surface->depthbuffer);
+        if(gl->CheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            logger.get()->warn("[PNT]Headless framebuffer is incomplete");
+        }
+    }
+
+    // Headless surface definitions.
+
+    headlessSurface* createHeadlessSurface(int width, int height, GladGLContext* openglContext) {
+        if(!initEGL()) {
+            return nullptr;
+        }
+
+        const EGLint configAttributes[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8,
+            EGL_GREEN_SIZE, 8,
+            EGL_BLUE_SIZE, 8,
+            EGL_ALPHA_SIZE, 8,
+            EGL_NONE
+        };
+        EGLConfig config;
+        EGLint configCount = 0;
+        if(!eglBindAPI(EGL_OPENGL_API) || !eglChooseConfig(eglDisplay, configAttributes, &config, 1, &configCount) || configCount == 0) {
+            logger.get()->error("[PNT]No EGL config supports desktop opengl (error 0x{:X})", eglGetError());
+            return nullptr;
+        }
+
+        if(eglShareContext == EGL_NO_CONTEXT) {
+            eglShareContext = eglCreateContext(eglDisplay, config, EGL_NO_CONTEXT, nullptr);
+        }
+
+        headlessSurface* surface = new headlessSurface;
+        surface->openglContext = openglContext;
+        surface->context = eglCreateContext(eglDisplay, config, eglShareContext, nullptr);
+        if(surface->context == EGL_NO_CONTEXT) {
+            logger.get()->error("[PNT]Failed to create an EGL context (error 0x{:X})", eglGetError());
+            delete surface;
+            return nullptr;
+        }
+        // Everything is drawn into the framebuffer object, the pbuffer only exists for drivers that can't go without a surface.
+        if(!hasExtension(eglQueryString(eglDisplay, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context")) {
+            const EGLint pbufferAttributes[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+            surface->surface = eglCreatePbufferSurface(eglDisplay, config, pbufferAttributes);
+        }
+        headlessSurfaces++;
+
+        if(!makeHeadlessCurrent(surface) || !gladLoadGLContext(openglContext, (GLADloadfunc)eglGetProcAddress)) {
+            logger.get()->error("[PNT]Failed to make the headless context current (error 0x{:X})", eglGetError());
+            destroyHeadlessSurface(surface);
+            return nullptr;
+        }
+        createFramebuffer(surface, width, height);
+        return surface;
+    }
+
+    void destroyHeadlessSurface(headlessSurface* surface) {
+        if(surface == nullptr) {
+            return;
+        }
+
+        if(surface->framebuffer && makeHeadlessCurrent(surface)) {
+            surface->openglContext->DeleteFramebuffers(1, &surface->framebuffer);
+            surface->openglContext->DeleteRenderbuffers(1, &surface->colorbuffer);
+            surface->openglContext->DeleteRenderbuffers(1, &surface->depthbuffer);
+        }
+        eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if(surface->surface != EGL_NO_SURFACE) {
+            eglDestroySurface(eglDisplay, surface->surface);
+        }
+        eglDestroyContext(eglDisplay, surface->context);
+        delete surface;
+
+        if(--headlessSurfaces == 0) {
+            if(eglShareContext != EGL_NO_CONTEXT) {
+                eglDestroyContext(eglDisplay, eglShareContext);
+                eglShareContext = EGL_NO_CONTEXT;
+            }
+            eglTerminate(eglDisplay);
+            eglDisplay = EGL_NO_DISPLAY;
+        }
+    }
+
+    bool makeHeadlessCurrent(headlessSurface* surface) {
+        return eglMakeCurrent(eglDisplay, surface->surface, surface->surface, surface->context);
+    }
+
+    void resizeHeadlessSurface(headlessSurface* surface, int width, int height) {
+        GladGLContext* gl = surface->openglContext;
+        width = width > 0 ? width : 1;
+        height = height > 0 ? height : 1;
+        if(width == surface->width && height == surface->height) {
+            return;
+        }
+        surface->width = width;
+        surface->height = height;
+        gl->BindRenderbuffer(GL_RENDERBUFFER, surface->colorbuffer);
+        gl->RenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        gl->BindRenderbuffer(GL_RENDERBUFFER, surface->depthbuffer);
+        gl->RenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        gl->BindRenderbuffer(GL_RENDERBUFFER, 0);
+    }
+
+    GLuint getHeadlessFramebuffer(const headlessSurface* surface) {
+        return surface->framebuffer;
+    }
+
+    const void* getHeadlessShareGroup() {
+        return eglShareContext;
+    }
+#else
+    struct headlessSurface {
+    };
+
+    headlessSurface* createHeadlessSurface(int, int, GladGLContext*) {
+        logger.get()->error("[PNT]Headless windows need EGL, which isn't available on this platform");
+        return nullptr;
+    }
+
+    void destroyHeadlessSurface(headlessSurface*) {
+    }
+
+    bool makeHeadlessCurrent(headlessSurface*) {
+        return false;
+    }
+
+    void resizeHeadlessSurface(headlessSurface*, int, int) {
+    }
+
+    GLuint getHeadlessFramebuffer(const headlessSurface*) {
+        return 0;
+    }
+
+    const void* getHeadlessShareGroup() {
+        return nullptr;
+    }
+#endif
+}
@@ -0,0 +1,623 @@
+#include <PNT/imguiRenderer.hpp>
+
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <string.h>
+#include <stdint.h>
+#include <imgui.h>
+#include <spdlog/spdlog.h>
+
+namespace PNT {
+    extern std::shared_ptr<spdlog::logger> logger;
+
+    struct rendererGroup {
+        const void* key;
+        int users;
+        GLuint program;
+        GLint projectionLocation;
+        GLint textureLocation;
+        GLuint batchProgram;
+        GLint batchProjectionLocation;
+        GLint batchTextureLocation;
+        GLuint fontTexture;
+        uint64_t fontGeneration;
+    };
+
+    // Draw commands reference the font through this id, each group swaps in its own texture since one atlas serves several share groups.
+    static const ImTextureID fontTextureId = (ImTextureID)(intptr_t)-1;
+
+    static std::vector<rendererGroup*> rendererGroups;
+    static ImFontAtlas* sharedFontAtlas = nullptr;
+
+    // The atlas belongs to the thread building the ui, uploads work from this copy so renderers on other threads never touch it.
+    static std::mutex fontMutex;
+    static std::vector<unsigned char> fontPixels;
+    static int fontWidth = 0;
+    static int fontHeight = 0;
+    static uint64_t fontGeneration = 0;
+
+#ifdef __APPLE__
+    static const char* const shaderVersion = "#version 150\n";
+#else
+    static const char* const shaderVersion = "#version 130\n";
+#endif
+
+    static const char* const vertexShaderSource =
+        "uniform mat4 ProjMtx;\n"
+        "in vec2 Position;\n"
+        "in vec2 UV;\n"
+        "in vec4 Color;\n"
+        "out vec2 Frag_UV;\n"
+        "out vec4 Frag_Color;\n"
+        "void main() {\n"
+        "    Frag_UV = UV;\n"
+        "    Frag_Color = Color;\n"
+        "    gl_Position = ProjMtx * vec4(Position.xy, 0.0, 1.0);\n"
+        "}\n";
+
+    static const char* const fragmentShaderSource =
+        "uniform sampler2D Texture;\n"
+        "in vec2 Frag_UV;\n"
+        "in vec4 Frag_Color;\n"
+        "out vec4 Out_Color;\n"
+        "void main() {\n"
+        "    Out_Color = Frag_Color * texture(Texture, Frag_UV.st);\n"
+        "}\n";
+
+    // Multi draws can't change the scissor box between draws, so each draw carries its box as an instanced attribute picked by its base instance.
+    static const char* const batchShaderVersion = "#version 330 core\n";
+
+    static const char* const batchVertexShaderSource =
+        "uniform mat4 ProjMtx;\n"
+        "in vec2 Position;\n"
+        "in vec2 UV;\n"
+        "in vec4 Color;\n"
+        "in vec4 ClipRect;\n"
+        "out vec2 Frag_UV;\n"
+        "out vec4 Frag_Color;\n"
+        "flat out vec4 Frag_ClipRect;\n"
+        "void main() {\n"
+        "    Frag_UV = UV;\n"
+        "    Frag_Color = Color;\n"
+        "    Frag_ClipRect = ClipRect;\n"
+        "    gl_Position = ProjMtx * vec4(Position.xy, 0.0, 1.0);\n"
+        "}\n";
+
+    static const char* const batchFragmentShaderSource =
+        "uniform sampler2D Texture;\n"
+        "in vec2 Frag_UV;\n"
+        "in vec4 Frag_Color;\n"
+        "flat in vec4 Frag_ClipRect;\n"
+        "out vec4 Out_Color;\n"
+        "void main() {\n"
+        "    if(any(lessThan(gl_FragCoord.xy, Frag_ClipRect.xy)) || any(greaterThanEqual(gl_FragCoord.xy, Frag_ClipRect.zw))) {\n"
+        "        discard;\n"
+        "    }\n"
+        "    Out_Color = Frag_Color * texture(Texture, Frag_UV.st);\n"
+        "}\n";
+
+    static GLuint compileShader(GladGLContext* gl, GLenum type, const char* version, const char* source) {
+        const char* sources[2] = {version, source};
+        GLuint shader = gl->CreateShader(type);
+        gl->ShaderSource(shader, 2, sources, nullptr);
+        gl->CompileShader(shader);
+
+        GLint status = 0;
+        gl->GetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        if(!status) {
+            char log[512] = {0};
+            gl->GetShaderInfoLog(shader, sizeof(log), nullptr, log);
+            logger.get()->error("[PNT]Failed to compile the imgui {} shader: {}", type == GL_VERTEX_SHADER ? "vertex" : "fragment", log);
+        }
+        return shader;
+    }
+
+    static GLuint createProgram(GladGLContext* gl, const char* version, const char* vertexSource, const char* fragmentSource) {
+        GLuint vertexShader = compileShader(gl, GL_VERTEX_SHADER, version, vertexSource);
+        GLuint fragmentShader = compileShader(gl, GL_FRAGMENT_SHADER, version, fragmentSource);
+        GLuint program = gl->CreateProgram();
+        gl->AttachShader(program, vertexShader);
+        gl->AttachShader(program, fragmentShader);
+        // Fixed locations keep the vertex layout independent of the program, so every context can set it up the same way.
+        gl->BindAttribLocation(program, 0, "Position");
+        gl->BindAttribLocation(program, 1, "UV");
+        gl->BindAttribLocation(program, 2, "Color");
+        gl->BindAttribLocation(program, 3, "ClipRect");
+        gl->LinkProgram(program);
+        gl->DetachShader(program, vertexShader);
+        gl->DetachShader(program, fragmentShader);
+        gl->DeleteShader(vertexShader);
+        gl->DeleteShader(fragmentShader);
+
+        GLint status = 0;
+        gl->GetProgramiv(program, GL_LINK_STATUS, &status);
+        if(!status) {
+            char log[512] = {0};
+            gl->GetProgramInfoLog(program, sizeof(log), nullptr, log);
+            logger.get()->error("[PNT]Failed to link an imgui program: {}", log);
+            gl->DeleteProgram(program);
+            return 0;
+        }
+        return program;
+    }
+
+    static void createPrograms(GladGLContext* gl, rendererGroup* group) {
+        group->program = createProgram(gl, shaderVersion, vertexShaderSource, fragmentShaderSource);
+        if(group->program != 0) {
+            group->projectionLocation = gl->GetUniformLocation(group->program, "ProjMtx");
+            group->textureLocation = gl->GetUniformLocation(group->program, "Texture");
+        }
+        if(gl->VERSION_4_3) {
+            group->batchProgram = createProgram(gl, batchShaderVersion, batchVertexShaderSource, batchFragmentShaderSource);
+        }
+        if(group->batchProgram != 0) {
+            group->batchProjectionLocation = gl->GetUniformLocation(group->batchProgram, "ProjMtx");
+            group->batchTextureLocation = gl->GetUniformLocation(group->batchProgram, "Texture");
+        }
+    }
+
+    // imgui renderer definitions.
+
+    imguiRenderer::imguiRenderer() : m_openglContext(nullptr), m_group(nullptr), m_fontTexture(0), m_vertexArray(0), m_streamBuffer(), m_viewportBuffer(), m_hasVertexOffset(false), m_batchDraws(false) {
+    }
+
+    void imguiRenderer::init(GladGLContext* openglContext, const void* shareGroup) {
+        m_openglContext = openglContext;
+        if(!m_openglContext->VERSION_3_0) {
+            logger.get()->error("[PNT]Rendering imgui needs OpenGL 3.0");
+        }
+
+        for(rendererGroup* group : rendererGroups) {
+            if(group->key == shareGroup) {
+                m_group = group;
+                break;
+            }
+        }
+        if(m_group == nullptr) {
+            m_group = new rendererGroup{shareGroup, 0, 0, -1, -1, 0, -1, -1, 0, UINT64_MAX};
+            rendererGroups.emplace_back(m_group);
+            if(m_openglContext->VERSION_3_0) {
+                createPrograms(m_openglContext, m_group);
+            }
+            logger.get()->debug("[PNT]Created imgui objects for a new share group");
+        }
+        m_group->users++;
+
+        // Vertex arrays can't be shared between contexts, the buffers could but one per window avoids syncing between them.
+        if(m_openglContext->VERSION_3_0) {
+            m_openglContext->GenVertexArrays(1, &m_vertexArray);
+        }
+        m_streamBuffer.init(m_openglContext, true);
+        m_viewportBuffer.init(m_openglContext, false);
+        m_hasVertexOffset = m_openglContext->VERSION_3_2;
+        m_batchDraws = m_group->batchProgram != 0;
+        logger.get()->debug("[PNT]Streaming imgui vertices through {}, {}", m_streamBuffer.isPersistent() ? "a persistently mapped ring" : "orphaned buffers", m_batchDraws ? "drawn with multi draws" : "drawn command by command");
+
+        ImGuiIO& io = ImGui::GetIO();
+        io.BackendRendererUserData = this;
+        io.BackendRendererName = "PNT::imguiRenderer";
+        io.BackendFlags |= ImGuiBackendFlags_RendererHasViewports;
+        if(m_hasVertexOffset) {
+            io.BackendFlags |= ImGuiBackendFlags_RendererHasVtxOffset;
+        }
+        ImGui::GetPlatformIO().Renderer_RenderWindow = renderWindow;
+    }
+
+    void imguiRenderer::shutdown() {
+        if(m_openglContext == nullptr) {
+            return;
+        }
+
+        ImGuiIO& io = ImGui::GetIO();
+        io.BackendRendererUserData = nullptr;
+        io.BackendRendererName = nullptr;
+        io.BackendFlags &= ~(ImGuiBackendFlags_RendererHasViewports | ImGuiBackendFlags_RendererHasVtxOffset);
+        ImGui::GetPlatformIO().Renderer_RenderWindow = nullptr;
+
+        if(m_vertexArray != 0) {
+            m_openglContext->DeleteVertexArrays(1, &m_vertexArray);
+        }
+        m_vertexArray = 0;
+        m_streamBuffer.shutdown();
+        m_viewportBuffer.shutdown();
+
+        if(--m_group->users == 0) {
+            if(m_group->program != 0) {
+                m_openglContext->DeleteProgram(m_group->program);
+            }
+            if(m_group->batchProgram != 0) {
+                m_openglContext->DeleteProgram(m_group->batchProgram);
+            }
+            if(m_group->fontTexture != 0) {
+                m_openglContext->DeleteTextures(1, &m_group->fontTexture);
+            }
+            rendererGroups.erase(std::find(rendererGroups.begin(), rendererGroups.end(), m_group));
+            delete m_group;
+        }
+        m_group = nullptr;
+        m_openglContext = nullptr;
+    }
+
+    void imguiRenderer::uploadFonts() {
+        GLint lastTexture;
+        m_openglContext->GetIntegerv(GL_TEXTURE_BINDING_2D, &lastTexture);
+        if(m_group->fontTexture == 0) {
+            m_openglContext->GenTextures(1, &m_group->fontTexture);
+        }
+        m_openglContext->BindTexture(GL_TEXTURE_2D, m_group->fontTexture);
+        m_openglContext->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        m_openglContext->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        m_openglContext->PixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        m_openglContext->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, fontWidth, fontHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, fontPixels.data());
+        m_openglContext->BindTexture(GL_TEXTURE_2D, (GLuint)lastTexture);
+
+        m_group->fontGeneration = fontGeneration;
+        logger.get()->debug("[PNT]Uploaded the {}x{} font atlas", fontWidth, fontHeight);
+    }
+
+    void imguiRenderer::newFrame() {
+        if(m_group == nullptr || m_group->program == 0) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(fontMutex);
+        if(m_group->fontGeneration != fontGeneration && !fontPixels.empty()) {
+            uploadFonts();
+        }
+        m_fontTexture = m_group->fontTexture;
+    }
+
+    void imguiRenderer::setupRenderState(ImDrawData* drawData, int width, int height, GLuint vertexArray, GLuint buffer, bool batched) {
+        GladGLContext* gl = m_openglContext;
+        gl->Enable(GL_BLEND);
+        gl->BlendEquation(GL_FUNC_ADD);
+        gl->BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        gl->Disable(GL_CULL_FACE);
+        gl->Disable(GL_DEPTH_TEST);
+        gl->Disable(GL_STENCIL_TEST);
+        // Batched draws clip in the fragment shader.
+        batched ? gl->Disable(GL_SCISSOR_TEST) : gl->Enable(GL_SCISSOR_TEST);
+        gl->Viewport(0, 0, (GLsizei)width, (GLsizei)height);
+
+        float left = drawData->DisplayPos.x;
+        float right = drawData->DisplayPos.x + drawData->DisplaySize.x;
+        float top = drawData->DisplayPos.y;
+        float bottom = drawData->DisplayPos.y + drawData->DisplaySize.y;
+        const float projection[4][4] = {
+            {2.0f / (right - left), 0.0f, 0.0f, 0.0f},
+            {0.0f, 2.0f / (top - bottom), 0.0f, 0.0f},
+            {0.0f, 0.0f, -1.0f, 0.0f},
+            {(right + left) / (left - right), (top + bottom) / (bottom - top), 0.0f, 1.0f},
+        };
+        if(batched) {
+            gl->UseProgram(m_group->batchProgram);
+            gl->Uniform1i(m_group->batchTextureLocation, 0);
+            gl->UniformMatrix4fv(m_group->batchProjectionLocation, 1, GL_FALSE, &projection[0][0]);
+        } else {
+            gl->UseProgram(m_group->program);
+            gl->Uniform1i(m_group->textureLocation, 0);
+            gl->UniformMatrix4fv(m_group->projectionLocation, 1, GL_FALSE, &projection[0][0]);
+        }
+        if(gl->VERSION_3_3) {
+            gl->BindSampler(0, 0);
+        }
+
+        // Vertices and indices share one buffer, so it is bound to both targets.
+        gl->BindVertexArray(vertexArray);
+        gl->BindBuffer(GL_ARRAY_BUFFER, buffer);
+        gl->BindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer);
+        gl->EnableVertexAttribArray(0);
+        gl->EnableVertexAttribArray(1);
+        gl->EnableVertexAttribArray(2);
+        if(batched) {
+            gl->EnableVertexAttribArray(3);
+            gl->VertexAttribDivisor(3, 1);
+            gl->BindBuffer(GL_DRAW_INDIRECT_BUFFER, buffer);
+        } else if(m_batchDraws) {
+            gl->DisableVertexAttribArray(3);
+        }
+        gl->ActiveTexture(GL_TEXTURE0);
+    }
+
+    void imguiRenderer::bindVertices(size_t offset) {
+        GladGLContext* gl = m_openglContext;
+        gl->VertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)(offset + offsetof(ImDrawVert, pos)));
+        gl->VertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert), (GLvoid*)(offset + offsetof(ImDrawVert, uv)));
+        gl->VertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert), (GLvoid*)(offset + offsetof(ImDrawVert, col)));
+    }
+
+    void imguiRenderer::buildBatches(ImDrawData* drawData, int height) {
+        m_indirectCommands.clear();
+        m_clipRects.clear();
+        m_batches.clear();
+
+        // Imgui draws in painter's order, so commands are only merged with their neighbours and never reordered.
+        ImVec2 clipOffset = drawData->DisplayPos;
+        ImVec2 clipScale = drawData->FramebufferScale;
+        GLuint vertexBase = 0;
+        GLuint indexBase = 0;
+        for(int i = 0; i < drawData->CmdListsCount; i++) {
+            const ImDrawList* drawList = drawData->CmdLists[i];
+            for(int j = 0; j < drawList->CmdBuffer.Size; j++) {
+                const ImDrawCmd* command = &drawList->CmdBuffer[j];
+                if(command->UserCallback != nullptr) {
+                    m_batches.emplace_back(drawBatch{0, 0, 0, drawList, command});
+                    continue;
+                }
+
+                ImVec2 clipMin((command->ClipRect.x - clipOffset.x) * clipScale.x, (command->ClipRect.y - clipOffset.y) * clipScale.y);
+                ImVec2 clipMax((command->ClipRect.z - clipOffset.x) * clipScale.x, (command->ClipRect.w - clipOffset.y) * clipScale.y);
+                if(clipMax.x <= clipMin.x || clipMax.y <= clipMin.y) {
+                    continue;
+                }
+                // The same integer box the scissor test of the unbatched path would use.
+                GLint left = (GLint)clipMin.x;
+                GLint bottom = (GLint)((float)height - clipMax.y);
+                clipRect clip{(float)left, (float)bottom, (float)(left + (GLsizei)(clipMax.x - clipMin.x)), (float)(bottom + (GLsizei)(clipMax.y - clipMin.y))};
+
+                ImTextureID texture = command->GetTexID();
+                GLuint textureName = texture == fontTextureId ? m_fontTexture : (GLuint)(intptr_t)texture;
+                GLuint firstIndex = indexBase + command->IdxOffset;
+                GLint baseVertex = (GLint)(vertexBase + command->VtxOffset);
+                if(!m_batches.empty() && m_batches.back().callback == nullptr && m_batches.back().texture == textureName) {
+                    // Imgui splits commands for reasons a multi draw doesn't care about, a neighbour continuing the indices with the same box extends the previous draw.
+                    indirectCommand& previous = m_indirectCommands.back();
+                    const clipRect& previousClip = m_clipRects.back();
+                    if(previous.baseVertex == baseVertex && previous.firstIndex + previous.count == firstIndex && memcmp(&previousClip, &clip, sizeof(clipRect)) == 0) {
+                        previous.count += command->ElemCount;
+                        continue;
+                    }
+                    m_batches.back().count++;
+                } else {
+                    m_batches.emplace_back(drawBatch{textureName, m_indirectCommands.size(), 1, nullptr, nullptr});
+                }
+                m_indirectCommands.emplace_back(indirectCommand{command->ElemCount, 1, firstIndex, baseVertex, (GLuint)m_clipRects.size()});
+                m_clipRects.emplace_back(clip);
+            }
+            vertexBase += (GLuint)drawList->VtxBuffer.Size;
+            indexBase += (GLuint)drawList->IdxBuffer.Size;
+        }
+    }
+
+    void imguiRenderer::renderBatches(ImDrawData* drawData, int width, int height, GLuint vertexArray, streamBuffer& buffer, size_t clipStart, size_t commandStart) {
+        GladGLContext* gl = m_openglContext;
+        auto setupBatchState = [&]() {
+            setupRenderState(drawData, width, height, vertexArray, buffer.getBuffer(), true);
+            bindVertices(buffer.getOffset());
+            gl->VertexAttribPointer(3, 4, GL_FLOAT, GL_FALSE, sizeof(clipRect), (GLvoid*)(buffer.getOffset() + clipStart));
+        };
+        setupBatchState();
+
+        GLenum indexType = sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        for(const drawBatch& batch : m_batches) {
+            if(batch.callback != nullptr) {
+                if(batch.callback->UserCallback == ImDrawCallback_ResetRenderState) {
+                    setupBatchState();
+                } else {
+                    batch.callback->UserCallback(batch.callbackList, batch.callback);
+                }
+                continue;
+            }
+            gl->BindTexture(GL_TEXTURE_2D, batch.texture);
+            const void* commands = (const void*)(intptr_t)(buffer.getOffset() + commandStart + batch.first * sizeof(indirectCommand));
+            gl->MultiDrawElementsIndirect(GL_TRIANGLES, indexType, commands, (GLsizei)batch.count, 0);
+        }
+    }
+
+    void imguiRenderer::renderDrawData(ImDrawData* drawData, bool ownContext) {
+        int width = (int)(drawData->DisplaySize.x * drawData->FramebufferScale.x);
+        int height = (int)(drawData->DisplaySize.y * drawData->FramebufferScale.y);
+        if(width <= 0 || height <= 0 || m_group == nullptr || m_group->program == 0) {
+            return;
+        }
+        GladGLContext* gl = m_openglContext;
+
+        // User drawing around imgui shouldn't have to redo its state every frame.
+        GLint lastProgram, lastTexture, lastArrayBuffer, lastVertexArray, lastActiveTexture;
+        GLint lastViewport[4], lastScissorBox[4];
+        GLint lastBlendSourceRGB, lastBlendDestinationRGB, lastBlendSourceAlpha, lastBlendDestinationAlpha, lastBlendEquationRGB, lastBlendEquationAlpha;
+        gl->GetIntegerv(GL_CURRENT_PROGRAM, &lastProgram);
+        gl->GetIntegerv(GL_ACTIVE_TEXTURE, &lastActiveTexture);
+        gl->ActiveTexture(GL_TEXTURE0);
+        gl->GetIntegerv(GL_TEXTURE_BINDING_2D, &lastTexture);
+        gl->GetIntegerv(GL_ARRAY_BUFFER_BINDING, &lastArrayBuffer);
+        gl->GetIntegerv(GL_VERTEX_ARRAY_BINDING, &lastVertexArray);
+        gl->GetIntegerv(GL_VIEWPORT, lastViewport);
+        gl->GetIntegerv(GL_SCISSOR_BOX, lastScissorBox);
+        gl->GetIntegerv(GL_BLEND_SRC_RGB, &lastBlendSourceRGB);
+        gl->GetIntegerv(GL_BLEND_DST_RGB, &lastBlendDestinationRGB);
+        gl->GetIntegerv(GL_BLEND_SRC_ALPHA, &lastBlendSourceAlpha);
+        gl->GetIntegerv(GL_BLEND_DST_ALPHA, &lastBlendDestinationAlpha);
+        gl->GetIntegerv(GL_BLEND_EQUATION_RGB, &lastBlendEquationRGB);
+        gl->GetIntegerv(GL_BLEND_EQUATION_ALPHA, &lastBlendEquationAlpha);
+        GLboolean lastBlend = gl->IsEnabled(GL_BLEND);
+        GLboolean lastCullFace = gl->IsEnabled(GL_CULL_FACE);
+        GLboolean lastDepthTest = gl->IsEnabled(GL_DEPTH_TEST);
+        GLboolean lastStencilTest = gl->IsEnabled(GL_STENCIL_TEST);
+        GLboolean lastScissorTest = gl->IsEnabled(GL_SCISSOR_TEST);
+        GLint lastIndirectBuffer = 0;
+        if(m_batchDraws) {
+            gl->GetIntegerv(GL_DRAW_INDIRECT_BUFFER_BINDING, &lastIndirectBuffer);
+        }
+
+        // Platform windows have their own context, which can use the shared buffers but needs a vertex array of its own.
+        GLuint vertexArray = m_vertexArray;
+        if(!ownContext) {
+            gl->GenVertexArrays(1, &vertexArray);
+        }
+
+        // Every list of the frame goes into one submission, all vertices first and the indices after them.
+        size_t vertexSize = 0;
+        size_t indexSize = 0;
+        for(int i = 0; i < drawData->CmdListsCount; i++) {
+            vertexSize += (size_t)drawData->CmdLists[i]->VtxBuffer.Size * sizeof(ImDrawVert);
+            indexSize += (size_t)drawData->CmdLists[i]->IdxBuffer.Size * sizeof(ImDrawIdx);
+        }
+        size_t indexStart = (vertexSize + 15) & ~(size_t)15;
+        size_t size = indexStart + indexSize;
+        // Batched frames also carry a clip box and an indirect command per draw.
+        size_t clipStart = (size + 15) & ~(size_t)15;
+        size_t commandStart = clipStart;
+        if(m_batchDraws) {
+            buildBatches(drawData, height);
+            commandStart = clipStart + m_clipRects.size() * sizeof(clipRect);
+            size = commandStart + m_indirectCommands.size() * sizeof(indirectCommand);
+        }
+        streamBuffer& buffer = ownContext ? m_streamBuffer : m_viewportBuffer;
+        unsigned char* data = buffer.begin(size);
+        if(data != nullptr) {
+            size_t vertexOffset = 0;
+            size_t indexOffset = indexStart;
+            for(int i = 0; i < drawData->CmdListsCount; i++) {
+                const ImDrawList* drawList = drawData->CmdLists[i];
+                memcpy(data + vertexOffset, drawList->VtxBuffer.Data, (size_t)drawList->VtxBuffer.Size * sizeof(ImDrawVert));
+                memcpy(data + indexOffset, drawList->IdxBuffer.Data, (size_t)drawList->IdxBuffer.Size * sizeof(ImDrawIdx));
+                vertexOffset += (size_t)drawList->VtxBuffer.Size * sizeof(ImDrawVert);
+                indexOffset += (size_t)drawList->IdxBuffer.Size * sizeof(ImDrawIdx);
+            }
+            if(m_batchDraws) {
+                memcpy(data + clipStart, m_clipRects.data(), m_clipRects.size() * sizeof(clipRect));
+                // Indirect commands count indices from the start of the buffer, not of the submission.
+                GLuint indexBase = (GLuint)((buffer.getOffset() + indexStart) / sizeof(ImDrawIdx));
+                indirectCommand* commands = (indirectCommand*)(data + commandStart);
+                for(size_t i = 0; i < m_indirectCommands.size(); i++) {
+                    commands[i] = m_indirectCommands[i];
+                    commands[i].firstIndex += indexBase;
+                }
+            }
+            buffer.end();
+        }
+
+        if(data != nullptr && m_batchDraws) {
+            renderBatches(drawData, width, height, vertexArray, buffer, clipStart, commandStart);
+            buffer.finish();
+        } else if(data != nullptr) {
+            setupRenderState(drawData, width, height, vertexArray, buffer.getBuffer(), false);
+
+            ImVec2 clipOffset = drawData->DisplayPos;
+            ImVec2 clipScale = drawData->FramebufferScale;
+            GLenum indexType = sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            size_t vertexOffset = buffer.getOffset();
+            size_t indexOffset = buffer.getOffset() + indexStart;
+            for(int i = 0; i < drawData->CmdListsCount; i++) {
+                const ImDrawList* drawList = drawData->CmdLists[i];
+                bindVertices(vertexOffset);
+
+                for(int j = 0; j < drawList->CmdBuffer.Size; j++) {
+                    const ImDrawCmd* command = &drawList->CmdBuffer[j];
+                    if(command->UserCallback != nullptr) {
+                        if(command->UserCallback == ImDrawCallback_ResetRenderState) {
+                            setupRenderState(drawData, width, height, vertexArray, buffer.getBuffer(), false);
+                            bindVertices(vertexOffset);
+                        } else {
+                            command->UserCallback(drawList, command);
+                        }
+                        continue;
+                    }
+
+                    ImVec2 clipMin((command->ClipRect.x - clipOffset.x) * clipScale.x, (command->ClipRect.y - clipOffset.y) * clipScale.y);
+                    ImVec2 clipMax((command->ClipRect.z - clipOffset.x) * clipScale.x, (command->ClipRect.w - clipOffset.y) * clipScale.y);
+                    if(clipMax.x <= clipMin.x || clipMax.y <= clipMin.y) {
+                        continue;
+                    }
+                    gl->Scissor((GLint)clipMin.x, (GLint)((float)height - clipMax.y), (GLsizei)(clipMax.x - clipMin.x), (GLsizei)(clipMax.y - clipMin.y));
+
+                    ImTextureID texture = command->GetTexID();
+                    gl->BindTexture(GL_TEXTURE_2D, texture == fontTextureId ? m_fontTexture : (GLuint)(intptr_t)texture);
+                    const void* commandOffset = (const void*)(intptr_t)(indexOffset + command->IdxOffset * sizeof(ImDrawIdx));
+                    if(m_hasVertexOffset) {
+                        gl->DrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)command->ElemCount, indexType, commandOffset, (GLint)command->VtxOffset);
+                    } else {
+                        gl->DrawElements(GL_TRIANGLES, (GLsizei)command->ElemCount, indexType, commandOffset);
+                    }
+                }
+                vertexOffset += (size_t)drawList->VtxBuffer.Size * sizeof(ImDrawVert);
+                indexOffset += (size_t)drawList->IdxBuffer.Size * sizeof(ImDrawIdx);
+            }
+            buffer.finish();
+        }
+
+        if(!ownContext) {
+            gl->DeleteVertexArrays(1, &vertexArray);
+        }
+
+        gl->UseProgram((GLuint)lastProgram);
+        gl->BindTexture(GL_TEXTURE_2D, (GLuint)lastTexture);
+        gl->ActiveTexture((GLenum)lastActiveTexture);
+        gl->BindVertexArray((GLuint)lastVertexArray);
+        gl->BindBuffer(GL_ARRAY_BUFFER, (GLuint)lastArrayBuffer);
+        if(m_batchDraws) {
+            gl->BindBuffer(GL_DRAW_INDIRECT_BUFFER, (GLuint)lastIndirectBuffer);
+        }
+        gl->BlendEquationSeparate((GLenum)lastBlendEquationRGB, (GLenum)lastBlendEquationAlpha);
+        gl->BlendFuncSeparate((GLenum)lastBlendSourceRGB, (GLenum)lastBlendDestinationRGB, (GLenum)lastBlendSourceAlpha, (GLenum)lastBlendDestinationAlpha);
+        lastBlend ? gl->Enable(GL_BLEND) : gl->Disable(GL_BLEND);
+        lastCullFace ? gl->Enable(GL_CULL_FACE) : gl->Disable(GL_CULL_FACE);
+        lastDepthTest ? gl->Enable(GL_DEPTH_TEST) : gl->Disable(GL_DEPTH_TEST);
+        lastStencilTest ? gl->Enable(GL_STENCIL_TEST) : gl->Disable(GL_STENCIL_TEST);
+        lastScissorTest ? gl->Enable(GL_SCISSOR_TEST) : gl->Disable(GL_SCISSOR_TEST);
+        gl->Viewport(lastViewport[0], lastViewport[1], (GLsizei)lastViewport[2], (GLsizei)lastViewport[3]);
+        gl->Scissor(lastScissorBox[0], lastScissorBox[1], (GLsizei)lastScissorBox[2], (GLsizei)lastScissorBox[3]);
+    }
+
+    void imguiRenderer::render(ImDrawData* drawData) {
+        if(drawData == nullptr) {
+            return;
+        }
+        renderDrawData(drawData, true);
+    }
+
+    void imguiRenderer::renderWindow(ImGuiViewport* viewport, void*) {
+        imguiRenderer* renderer = (imguiRenderer*)ImGui::GetIO().BackendRendererUserData;
+        if(renderer == nullptr || renderer->m_openglContext == nullptr) {
+            return;
+        }
+
+        if(!(viewport->Flags & ImGuiViewportFlags_NoRendererClear)) {
+            renderer->m_openglContext->ClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            renderer->m_openglContext->Clear(GL_COLOR_BUFFER_BIT);
+        }
+        renderer->renderDrawData(viewport->DrawData, false);
+    }
+
+    // Font atlas definitions.
+
+    ImFontAtlas* getSharedFontAtlas() {
+        if(sharedFontAtlas == nullptr) {
+            sharedFontAtlas = new ImFontAtlas;
+        }
+        return sharedFontAtlas;
+    }
+
+    void prepareSharedFontAtlas() {
+        ImFontAtlas* atlas = getSharedFontAtlas();
+        if(!atlas->IsBuilt() || fontGeneration == 0) {
+            unsigned char* pixels;
+            int width, height;
+            atlas->GetTexDataAsRGBA32(&pixels, &width, &height);
+
+            std::lock_guard<std::mutex> lock(fontMutex);
+            fontPixels.assign(pixels, pixels + (size_t)width * (size_t)height * 4);
+            fontWidth = width;
+            fontHeight = height;
+            fontGeneration++;
+        }
+        if(atlas->TexID != fontTextureId) {
+            atlas->SetTexID(fontTextureId);
+        }
+    }
+
+    void destroySharedFontAtlas() {
+        delete sharedFontAtlas;
+        sharedFontAtlas = nullptr;
+
+        std::lock_guard<std::mutex> lock(fontMutex);
+        fontPixels = std::vector<unsigned char>();
+        // The next atlas starts a new generation so groups that outlive this one upload it again.
+        fontGeneration = 0;
+        for(rendererGroup* group : rendererGroups) {
+            group->fontGeneration = UINT64_MAX;
+        }
+    }
+}
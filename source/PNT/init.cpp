@@ -1,19 +1,35 @@
 #include <PNT/init.hpp>
 
+#include <thread>
 #define GLFW_INCLUDE_NONE
 #include <GLFW/glfw3.h>
 #include <spdlog/spdlog.h>
 #include <PNT/error.hpp>
 #include <PNT/window.hpp>
+#include <PNT/record.hpp>
+#include <PNT/trace.hpp>
+#include <PNT/screenshot.hpp>
+#include <PNT/imguiRenderer.hpp>
+#include <PNT/renderThread.hpp>
 
 namespace PNT {
     bool initialized = false;
+    std::thread::id mainThread;
     extern std::shared_ptr<spdlog::logger> logger;
 
     // Init/deinit definitions.
 
     bool init() {
         initialized = glfwInit();
+#ifdef GLFW_PLATFORM_NULL
+        // Without a display server only headless windows can be created, glfw still drives the event loop.
+        if(!initialized) {
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+            initialized = glfwInit();
+        }
+#endif
+        mainThread = std::this_thread::get_id();
+        Window::m_createdWindows = 0;
         logger.get()->flush_on(spdlog::level::trace);
         logger.get()->info("[PNT]Initializing Pentagram");
         glfwSetErrorCallback(errorCallback);
@@ -23,9 +39,24 @@ namespace PNT {
 
     void deinit() {
         logger.get()->info("[PNT]Shutting down Pentagram");
-        for(Window* window : Window::m_instancesList) {
-            window->destroyWindow();
+        stopRecording();
+        stopReplay();
+        stopFlightRecorder();
+        stopRenderThread();
+        // Destroying a window erases it from the list, so always take the last one until none are left.
+        // Every window has to be gone before the share window, share context and font atlas they build on.
+        while(!Window::m_instancesList.empty()) {
+            Window::m_instancesList.back()->destroyWindow();
+        }
+        stopScreenshots();
+        if(Window::m_shareWindow != nullptr) {
+            releaseResourceGroup(Window::m_shareWindow);
+            glfwDestroyWindow(Window::m_shareWindow);
+            Window::m_shareWindow = nullptr;
         }
+        delete Window::m_shareContext;
+        Window::m_shareContext = nullptr;
+        destroySharedFontAtlas();
         spdlog::shutdown();
         glfwTerminate();
         initialized = false;
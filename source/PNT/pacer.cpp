@@ -0,0 +1,76 @@
+#include <PNT/pacer.hpp>
+
+#include <thread>
+#include <algorithm>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+#endif
+
+namespace PNT {
+    // Frame pacer definitions.
+
+    framePacer::framePacer() : m_period(0), m_spinThreshold(std::chrono::microseconds(1000)), m_sleepError(0), m_deadline(), m_slack(0.0), m_targetFPS(0.0) {
+    }
+
+    framePacer::~framePacer() {
+        setTargetFPS(0.0);
+    }
+
+    void framePacer::setTargetFPS(double fps) {
+#ifdef _WIN32
+        // The default windows timer only wakes sleepers every ~15ms, which is useless for pacing.
+        if(fps > 0.0 && m_targetFPS <= 0.0) {
+            timeBeginPeriod(1);
+        } else if(fps <= 0.0 && m_targetFPS > 0.0) {
+            timeEndPeriod(1);
+        }
+#endif
+        m_targetFPS = fps > 0.0 ? fps : 0.0;
+        m_period = fps > 0.0 ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps)) : std::chrono::steady_clock::duration(0);
+        m_deadline = std::chrono::steady_clock::now();
+    }
+
+    void framePacer::setSpinThreshold(std::chrono::duration<double> spinThreshold) {
+        m_spinThreshold = std::chrono::duration_cast<std::chrono::steady_clock::duration>(spinThreshold);
+    }
+
+    void framePacer::wait() {
+        if(m_period.count() == 0) {
+            return;
+        }
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        m_deadline += m_period;
+        m_slack = m_deadline - now;
+
+        // A frame that missed by a whole period starts a new schedule instead of racing to catch up.
+        if(now - m_deadline > m_period) {
+            m_deadline = now;
+            return;
+        }
+
+        std::chrono::steady_clock::time_point wakeup = m_deadline - std::max(m_spinThreshold, m_sleepError);
+        if(now < wakeup) {
+            std::this_thread::sleep_until(wakeup);
+            std::chrono::steady_clock::duration overshoot = std::chrono::steady_clock::now() - wakeup;
+            // Decay slowly so one lucky sleep doesn't shrink the margin for the next frame.
+            m_sleepError = std::max(overshoot, m_sleepError - m_sleepError / 16);
+        }
+
+        while(std::chrono::steady_clock::now() < m_deadline) {
+            std::this_thread::yield();
+        }
+    }
+
+    double framePacer::getTargetFPS() const {
+        return m_targetFPS;
+    }
+
+    std::chrono::duration<double> framePacer::getSlack() const {
+        return m_slack;
+    }
+}
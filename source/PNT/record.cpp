@@ -0,0 +1,345 @@
+#include <PNT/record.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <spdlog/spdlog.h>
+#include <PNT/event.hpp>
+#include <PNT/window.hpp>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace PNT {
+    extern std::shared_ptr<spdlog::logger> logger;
+
+    // Event log layout: one header followed by records, drop records are followed by their NUL terminated paths.
+
+    struct recordHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t eventSize;
+    };
+
+    struct eventRecord {
+        uint64_t time;
+        uint64_t frame;
+        // Creation id of the window, see "Window::m_creationId".
+        uint32_t window;
+        uint32_t extraSize;
+        windowEvent event;
+    };
+
+    static constexpr char recordMagic[8] = {'P', 'N', 'T', 'E', 'V', 'L', 'O', 'G'};
+    static constexpr uint32_t recordVersion = 2;
+
+    struct mappedFile {
+        const unsigned char* data = nullptr;
+        size_t size = 0;
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#endif
+    };
+
+    static uint64_t eventFrame = 0;
+
+    static FILE* recordFile = nullptr;
+    static std::chrono::steady_clock::time_point recordStart;
+    static std::vector<char> recordBuffer;
+
+    static mappedFile replayFile;
+    static size_t replayOffset = 0;
+    static replayModes replayMode;
+    static std::chrono::steady_clock::time_point replayStart;
+    static uint64_t replayFrameOffset = 0;
+    static bool replayDispatching = false;
+    static std::vector<const char*> replayPaths;
+
+    static bool mapFile(const std::string& path, mappedFile& file) {
+#ifdef _WIN32
+        file.file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(file.file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size;
+        GetFileSizeEx(file.file, &size);
+        file.size = (size_t)size.QuadPart;
+        if(file.size != 0) {
+            file.mapping = CreateFileMappingA(file.file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if(file.mapping != nullptr) {
+                file.data = static_cast<const unsigned char*>(MapViewOfFile(file.mapping, FILE_MAP_READ, 0, 0, 0));
+            }
+        }
+#else
+        int descriptor = open(path.c_str(), O_RDONLY);
+        if(descriptor < 0) {
+            return false;
+        }
+        struct stat status;
+        if(fstat(descriptor, &status) == 0 && status.st_size > 0) {
+            void* data = mmap(nullptr, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if(data != MAP_FAILED) {
+                file.data = static_cast<const unsigned char*>(data);
+                file.size = (size_t)status.st_size;
+                madvise(data, file.size, MADV_SEQUENTIAL);
+            }
+        }
+        close(descriptor);
+#endif
+        return file.data != nullptr;
+    }
+
+    static void unmapFile(mappedFile& file) {
+#ifdef _WIN32
+        if(file.data != nullptr) {
+            UnmapViewOfFile(file.data);
+        }
+        if(file.mapping != nullptr) {
+            CloseHandle(file.mapping);
+        }
+        if(file.file != INVALID_HANDLE_VALUE) {
+            CloseHandle(file.file);
+        }
+#else
+        if(file.data != nullptr) {
+            munmap(const_cast<unsigned char*>(file.data), file.size);
+        }
+#endif
+        file = mappedFile();
+    }
+
+    // Recording definitions.
+
+    bool startRecording(const std::string& path) {
+        if(isReplaying()) {
+            logger.get()->warn("[PNT]Can't record events while replaying");
+            return false;
+        }
+        stopRecording();
+
+        recordFile = std::fopen(path.c_str(), "wb");
+        if(recordFile == nullptr) {
+            logger.get()->error("[PNT]Failed to open event log \"{}\"", path);
+            return false;
+        }
+
+        logger.get()->info("[PNT]Recording events to \"{}\"", path);
+
+        // Records are small, a large buffer keeps the input callbacks away from the disk.
+        recordBuffer.resize(1 << 20);
+        std::setvbuf(recordFile, recordBuffer.data(), _IOFBF, recordBuffer.size());
+
+        recordHeader header;
+        std::memcpy(header.magic, recordMagic, sizeof(recordMagic));
+        header.version = recordVersion;
+        header.eventSize = sizeof(windowEvent);
+        std::fwrite(&header, sizeof(header), 1, recordFile);
+
+        recordStart = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    void stopRecording() {
+        if(recordFile != nullptr) {
+            logger.get()->info("[PNT]Stopping event recording");
+            std::fclose(recordFile);
+            recordFile = nullptr;
+            recordBuffer.clear();
+            recordBuffer.shrink_to_fit();
+        }
+    }
+
+    bool isRecording() {
+        return recordFile != nullptr;
+    }
+
+    bool captureInputEvent(const Window* window, const windowEvent& event) {
+        if(replayFile.data != nullptr) {
+            return replayDispatching;
+        }
+        if(recordFile == nullptr) {
+            return true;
+        }
+
+        eventRecord record;
+        std::memset(&record, 0, sizeof(record));
+        record.time = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - recordStart).count();
+        record.frame = eventFrame;
+        record.window = window->m_creationId;
+        record.event = event;
+        if(event.type == eventTypes::DROP) {
+            for(int i = 0; i < event.dropFiles.pathCount; i++) {
+                record.extraSize += (uint32_t)std::strlen(event.dropFiles.paths[i]) + 1;
+            }
+            record.event.dropFiles.paths = nullptr;
+        }
+
+        std::fwrite(&record, sizeof(record), 1, recordFile);
+        if(event.type == eventTypes::DROP) {
+            for(int i = 0; i < event.dropFiles.pathCount; i++) {
+                std::fwrite(event.dropFiles.paths[i], std::strlen(event.dropFiles.paths[i]) + 1, 1, recordFile);
+            }
+        }
+
+        return true;
+    }
+
+    // Replay definitions.
+
+    bool startReplay(const std::string& path, replayModes mode) {
+        stopRecording();
+        stopReplay();
+
+        if(!mapFile(path, replayFile)) {
+            logger.get()->error("[PNT]Failed to map event log \"{}\"", path);
+            unmapFile(replayFile);
+            return false;
+        }
+
+        recordHeader header;
+        if(replayFile.size < sizeof(header)) {
+            logger.get()->error("[PNT]Event log \"{}\" is too small", path);
+            unmapFile(replayFile);
+            return false;
+        }
+        std::memcpy(&header, replayFile.data, sizeof(header));
+        if(std::memcmp(header.magic, recordMagic, sizeof(recordMagic)) != 0 || header.version != recordVersion || header.eventSize != sizeof(windowEvent)) {
+            logger.get()->error("[PNT]\"{}\" is not an event log of this Pentagram build", path);
+            unmapFile(replayFile);
+            return false;
+        }
+
+        logger.get()->info("[PNT]Replaying events from \"{}\"", path);
+
+        replayOffset = sizeof(header);
+        replayMode = mode;
+        replayStart = std::chrono::steady_clock::now();
+        replayFrameOffset = eventFrame;
+        if(replayOffset + sizeof(eventRecord) <= replayFile.size) {
+            eventRecord first;
+            std::memcpy(&first, replayFile.data + replayOffset, sizeof(first));
+            replayFrameOffset = eventFrame - first.frame;
+        }
+        return true;
+    }
+
+    void stopReplay() {
+        if(replayFile.data != nullptr) {
+            logger.get()->info("[PNT]Stopping event replay");
+            unmapFile(replayFile);
+            replayOffset = 0;
+        }
+    }
+
+    bool isReplaying() {
+        return replayFile.data != nullptr;
+    }
+
+    void beginEventFrame() {
+        eventFrame++;
+        if(replayFile.data == nullptr) {
+            return;
+        }
+
+        uint64_t now = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - replayStart).count();
+        replayDispatching = true;
+        while(replayOffset + sizeof(eventRecord) <= replayFile.size) {
+            eventRecord record;
+            std::memcpy(&record, replayFile.data + replayOffset, sizeof(record));
+            if(replayMode == replayModes::REALTIME ? record.time > now : record.frame + replayFrameOffset > eventFrame) {
+                break;
+            }
+            if(replayOffset + sizeof(record) + record.extraSize > replayFile.size) {
+                replayOffset = replayFile.size;
+                break;
+            }
+
+            const char* extra = reinterpret_cast<const char*>(replayFile.data + replayOffset + sizeof(record));
+            replayOffset += sizeof(record) + record.extraSize;
+            std::vector<Window*>::iterator found = std::find_if(Window::m_instancesList.begin(), Window::m_instancesList.end(), [&record](const Window* window) {
+                return window->m_creationId == record.window;
+            });
+            if(found == Window::m_instancesList.end()) {
+                continue;
+            }
+            Window* window = *found;
+            GLFWwindow* glfwWindow = window->m_window;
+
+            const windowEvent& event = record.event;
+            if(event.type == eventTypes::DROP) {
+                replayPaths.clear();
+                for(int i = 0; i < event.dropFiles.pathCount; i++) {
+                    replayPaths.emplace_back(extra);
+                    extra += std::strlen(extra) + 1;
+                }
+            }
+            // Headless windows have no glfw callbacks, so their input goes through the queue like any injected event.
+            if(window->m_headless != nullptr) {
+                windowEvent injected = event;
+                if(injected.type == eventTypes::DROP) {
+                    injected.dropFiles.pathCount = (int)replayPaths.size();
+                    injected.dropFiles.paths = replayPaths.data();
+                }
+                window->pushEvent(injected);
+                continue;
+            }
+
+            switch(event.type) {
+                case eventTypes::KEYBOARD:
+                    callbackManagers::keyCallbackManager(glfwWindow, event.keyboard.key, event.keyboard.scancode, event.keyboard.action, event.keyboard.mods);
+                    break;
+                case eventTypes::CHAR:
+                    callbackManagers::charCallbackManager(glfwWindow, event.character.codepoint);
+                    break;
+                case eventTypes::DROP:
+                    callbackManagers::dropCallbackManager(glfwWindow, (int)replayPaths.size(), replayPaths.data());
+                    break;
+                case eventTypes::SCROLL:
+                    callbackManagers::scrollCallbackManager(glfwWindow, event.scroll.xoffset, event.scroll.yoffset);
+                    break;
+                case eventTypes::CURSORPOS:
+                    callbackManagers::cursorPosCallbackManager(glfwWindow, event.cursorpos.xpos, event.cursorpos.ypos);
+                    break;
+                case eventTypes::WINDOWPOS:
+                    callbackManagers::windowposCallbackManager(glfwWindow, event.windowpos.xpos, event.windowpos.ypos);
+                    break;
+                case eventTypes::WINDOWSIZE:
+                    callbackManagers::windowsizeCallbackManager(glfwWindow, event.windowsize.width, event.windowsize.height);
+                    break;
+                case eventTypes::CURSORENTER:
+                    callbackManagers::cursorEnterCallback(glfwWindow, event.cursorenter.entered);
+                    break;
+                case eventTypes::MOUSEBUTTON:
+                    callbackManagers::mousebuttonCallbackManager(glfwWindow, event.mousebutton.button, event.mousebutton.action, event.mousebutton.mods);
+                    break;
+                case eventTypes::WINDOWFOCUS:
+                    callbackManagers::windowFocusCallback(glfwWindow, event.windowfocus.focused);
+                    break;
+                case eventTypes::ICONIFY:
+                    callbackManagers::iconifyCallbackManager(glfwWindow, event.iconified);
+                    break;
+                default:
+                    break;
+            }
+        }
+        replayDispatching = false;
+
+        if(replayOffset + sizeof(eventRecord) > replayFile.size) {
+            logger.get()->info("[PNT]Event replay finished");
+            stopReplay();
+        }
+    }
+}
@@ -0,0 +1,260 @@
+#include <PNT/renderThread.hpp>
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <condition_variable>
+#include <spdlog/spdlog.h>
+#include <GLFW/glfw3.h>
+#include <PNT/window.hpp>
+#include <PNT/trace.hpp>
+
+namespace PNT {
+    extern std::shared_ptr<spdlog::logger> logger;
+
+    struct renderQueue {
+        Window* window;
+        // Oldest first, never longer than "renderQueueDepth".
+        std::vector<frameSnapshot*> frames;
+        // Snapshots done drawing, the queued ones plus the one drawn and the one being copied are all that is ever in use, so the pool stops growing after a few frames.
+        std::vector<frameSnapshot*> pool;
+    };
+
+    // Two frames let the ui run one frame ahead of the gpu without the latency of a deeper queue.
+    static constexpr size_t renderQueueDepth = 2;
+
+    static std::thread renderThread;
+    static std::mutex renderMutex;
+    static std::condition_variable renderCondition;
+    static std::condition_variable renderReleaseCondition;
+    static std::condition_variable renderTakenCondition;
+    static std::vector<renderQueue> renderQueues;
+    static std::vector<Window*> renderReleases;
+    static bool renderStopping = false;
+    static std::atomic<uint64_t> renderDropped = 0;
+
+    static renderQueue* findQueue(Window* window) {
+        for(renderQueue& queue : renderQueues) {
+            if(queue.window == window) {
+                return &queue;
+            }
+        }
+        return nullptr;
+    }
+
+    static bool hasRenderWork() {
+        return std::any_of(renderQueues.begin(), renderQueues.end(), [](const renderQueue& queue) {
+            return !queue.frames.empty();
+        });
+    }
+
+    void renderThreadLoop() {
+        std::vector<std::pair<Window*, frameSnapshot*>> batch;
+        std::unique_lock<std::mutex> lock(renderMutex);
+        while(true) {
+            renderCondition.wait(lock, [] {
+                return renderStopping || !renderReleases.empty() || hasRenderWork();
+            });
+
+            // Nothing is being drawn at this point, so the contexts asked for can be handed back.
+            if(renderStopping || !renderReleases.empty()) {
+                for(renderQueue& queue : renderQueues) {
+                    if(!renderStopping && std::find(renderReleases.begin(), renderReleases.end(), queue.window) == renderReleases.end()) {
+                        continue;
+                    }
+                    for(frameSnapshot* snapshot : queue.frames) {
+                        delete snapshot;
+                    }
+                    for(frameSnapshot* snapshot : queue.pool) {
+                        delete snapshot;
+                    }
+                    queue.frames.clear();
+                    queue.pool.clear();
+                    if(Window::m_currentWindow == queue.window) {
+                        glfwMakeContextCurrent(nullptr);
+                        Window::m_currentWindow = nullptr;
+                    }
+                }
+                std::erase_if(renderQueues, [](const renderQueue& queue) {
+                    return renderStopping || std::find(renderReleases.begin(), renderReleases.end(), queue.window) != renderReleases.end();
+                });
+                renderReleases.clear();
+                renderReleaseCondition.notify_all();
+                if(renderStopping) {
+                    return;
+                }
+                continue;
+            }
+
+            for(renderQueue& queue : renderQueues) {
+                if(!queue.frames.empty()) {
+                    batch.emplace_back(queue.window, queue.frames.front());
+                    queue.frames.erase(queue.frames.begin());
+                }
+            }
+            lock.unlock();
+            renderTakenCondition.notify_all();
+
+            {
+                traceZone zone("Render thread frame");
+                // Like "Window::renderAll()", everything is drawn before the swaps and only the last vsynced swap waits for vblank.
+                Window* primary = nullptr;
+                int primaryInterval = 0;
+                for(const std::pair<Window*, frameSnapshot*>& frame : batch) {
+                    Window* window = frame.first;
+                    if(Window::m_currentWindow != window) {
+                        window->makeContextCurrent();
+                    }
+                    window->beginGpuFrame();
+                    window->drawFrame(frame.second->drawData.get(), frame.second->width, frame.second->height, frame.second->clearColor, frame.second->frame);
+                    window->m_gpuProfiler.endFrame();
+                    if(frame.second->swapInterval != 0) {
+                        primary = window;
+                        primaryInterval = frame.second->swapInterval;
+                    }
+                }
+                for(const std::pair<Window*, frameSnapshot*>& frame : batch) {
+                    if(frame.first != primary) {
+                        frame.first->presentFrame(0);
+                    }
+                }
+                if(primary != nullptr) {
+                    primary->presentFrame(primaryInterval);
+                }
+            }
+            // "stopTracing()" and a flight recorder dump only see what the main thread flushes itself, so this thread hands its zones over after every batch (nothing to do while tracing is off).
+            flushTracing();
+
+            lock.lock();
+            for(const std::pair<Window*, frameSnapshot*>& frame : batch) {
+                // Windows can't be released while a batch is drawn, so every queue is still there.
+                findQueue(frame.first)->pool.emplace_back(frame.second);
+            }
+            batch.clear();
+        }
+    }
+
+    // Render thread definitions.
+
+    bool startRenderThread() {
+        if(isRenderThreadRunning()) {
+            return true;
+        }
+        for(Window* window : Window::m_instancesList) {
+            if(window->m_frame) {
+                logger.get()->error("[PNT]The render thread can't be started while window \"{}\" is inside a frame", window->m_data.title);
+                return false;
+            }
+        }
+
+        renderStopping = false;
+        renderDropped = 0;
+        renderThread = std::thread(renderThreadLoop);
+        for(Window* window : Window::m_instancesList) {
+            if(window->canRenderThreaded()) {
+                attachRenderThread(window);
+            }
+        }
+        logger.get()->info("[PNT]Started the render thread");
+        return true;
+    }
+
+    void stopRenderThread() {
+        if(!isRenderThreadRunning()) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(renderMutex);
+            renderStopping = true;
+        }
+        renderCondition.notify_one();
+        renderThread.join();
+        for(Window* window : Window::m_instancesList) {
+            window->m_threaded = false;
+        }
+        logger.get()->info("[PNT]Stopped the render thread, {} frames were dropped", renderDropped.load());
+    }
+
+    bool isRenderThreadRunning() {
+        return renderThread.joinable();
+    }
+
+    uint64_t getRenderThreadDropped() {
+        return renderDropped;
+    }
+
+    void attachRenderThread(Window* window) {
+        // A context can only be current on one thread, the render thread takes it over from here on.
+        if(Window::m_currentWindow == window) {
+            glfwMakeContextCurrent(nullptr);
+            Window::m_currentWindow = nullptr;
+        }
+
+        std::lock_guard<std::mutex> lock(renderMutex);
+        renderQueue& queue = renderQueues.emplace_back(renderQueue{window, {}, {}});
+        queue.frames.reserve(renderQueueDepth);
+        queue.pool.reserve(renderQueueDepth + 2);
+        window->m_threaded = true;
+    }
+
+    void detachRenderThread(Window* window) {
+        if(!window->m_threaded) {
+            return;
+        }
+
+        std::unique_lock<std::mutex> lock(renderMutex);
+        renderReleases.emplace_back(window);
+        renderCondition.notify_one();
+        renderReleaseCondition.wait(lock, [window] {
+            return findQueue(window) == nullptr;
+        });
+        window->m_threaded = false;
+    }
+
+    void submitRenderFrame(Window* window, const ImDrawData* drawData, int width, int height, const float clearColor[4], uint64_t frame, int swapInterval, bool blocking) {
+        frameSnapshot* snapshot = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(renderMutex);
+            renderQueue* queue = findQueue(window);
+            if(queue == nullptr) {
+                return;
+            }
+            if(!queue->pool.empty()) {
+                snapshot = queue->pool.back();
+                queue->pool.pop_back();
+            }
+        }
+        if(snapshot == nullptr) {
+            snapshot = new frameSnapshot;
+        }
+
+        // The copy happens outside the lock, the snapshot belongs to nobody else until it's queued.
+        snapshot->drawData.copy(drawData);
+        snapshot->width = width;
+        snapshot->height = height;
+        std::copy(clearColor, clearColor + 4, snapshot->clearColor);
+        snapshot->frame = frame;
+        snapshot->swapInterval = swapInterval;
+
+        {
+            std::unique_lock<std::mutex> lock(renderMutex);
+            renderQueue* queue = findQueue(window);
+            // Without a target rate nothing else paces the ui thread, waiting for the gpu to take the last frame keeps it from building frames that would only be dropped.
+            if(blocking) {
+                renderTakenCondition.wait(lock, [queue] {
+                    return queue->frames.empty();
+                });
+            }
+            if(queue->frames.size() == renderQueueDepth) {
+                queue->pool.emplace_back(queue->frames.front());
+                queue->frames.erase(queue->frames.begin());
+                renderDropped++;
+            }
+            queue->frames.emplace_back(snapshot);
+        }
+        renderCondition.notify_one();
+    }
+}
@@ -0,0 +1,189 @@
+#include <PNT/resources.hpp>
+
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+#include <spdlog/spdlog.h>
+
+namespace PNT {
+    extern std::shared_ptr<spdlog::logger> logger;
+
+    struct resourceControl {
+        int references;
+        GLuint name;
+        resourceTypes type;
+        uint64_t group;
+        std::string key;
+    };
+
+    struct resourceGroup {
+        const void* shareGroup;
+        uint64_t serial;
+        std::vector<std::pair<resourceTypes, GLuint>> deletes;
+        std::vector<resourceControl*> cache;
+    };
+
+    // Handles are copied far less often than they are used, so one lock guarding every count keeps the cache lookups simple.
+    static std::mutex resourceMutex;
+    static std::vector<resourceGroup> resourceGroups;
+    static uint64_t resourceSerial = 0;
+
+    static resourceGroup* findGroup(uint64_t serial) {
+        for(resourceGroup& group : resourceGroups) {
+            if(group.serial == serial) {
+                return &group;
+            }
+        }
+        return nullptr;
+    }
+
+    static resourceGroup* findGroup(const void* shareGroup) {
+        for(resourceGroup& group : resourceGroups) {
+            if(group.shareGroup == shareGroup) {
+                return &group;
+            }
+        }
+        return nullptr;
+    }
+
+    static void releaseControl(resourceControl* control) {
+        std::lock_guard<std::mutex> lock(resourceMutex);
+        if(--control->references > 0) {
+            return;
+        }
+
+        // A handle outliving its share group has nothing left to delete.
+        resourceGroup* group = findGroup(control->group);
+        if(group != nullptr) {
+            group->deletes.emplace_back(control->type, control->name);
+            if(!control->key.empty()) {
+                std::erase(group->cache, control);
+            }
+        }
+        delete control;
+    }
+
+    // GPU resource definitions.
+
+    gpuResource::gpuResource() : m_control(nullptr) {
+    }
+
+    gpuResource::gpuResource(resourceControl* control) : m_control(control) {
+    }
+
+    gpuResource::gpuResource(const gpuResource& other) : m_control(other.m_control) {
+        if(m_control != nullptr) {
+            std::lock_guard<std::mutex> lock(resourceMutex);
+            m_control->references++;
+        }
+    }
+
+    gpuResource::gpuResource(gpuResource&& other) noexcept : m_control(other.m_control) {
+        other.m_control = nullptr;
+    }
+
+    gpuResource::~gpuResource() {
+        reset();
+    }
+
+    gpuResource& gpuResource::operator=(const gpuResource& other) {
+        if(other.m_control != m_control) {
+            gpuResource copy(other);
+            std::swap(m_control, copy.m_control);
+        }
+        return *this;
+    }
+
+    gpuResource& gpuResource::operator=(gpuResource&& other) noexcept {
+        if(&other != this) {
+            reset();
+            m_control = other.m_control;
+            other.m_control = nullptr;
+        }
+        return *this;
+    }
+
+    GLuint gpuResource::get() const {
+        return m_control != nullptr ? m_control->name : 0;
+    }
+
+    resourceTypes gpuResource::getType() const {
+        return m_control != nullptr ? m_control->type : resourceTypes::TEXTURE;
+    }
+
+    bool gpuResource::valid() const {
+        return m_control != nullptr;
+    }
+
+    void gpuResource::reset() {
+        if(m_control != nullptr) {
+            releaseControl(m_control);
+            m_control = nullptr;
+        }
+    }
+
+    gpuResource createResource(const void* shareGroup, resourceTypes type, GLuint name, const std::string& key) {
+        std::lock_guard<std::mutex> lock(resourceMutex);
+        resourceGroup* group = findGroup(shareGroup);
+        if(group == nullptr) {
+            group = &resourceGroups.emplace_back(resourceGroup{shareGroup, ++resourceSerial, {}, {}});
+        }
+
+        resourceControl* control = new resourceControl{1, name, type, group->serial, key};
+        if(!key.empty()) {
+            group->cache.emplace_back(control);
+        }
+        return gpuResource(control);
+    }
+
+    gpuResource findResource(const void* shareGroup, const std::string& key) {
+        std::lock_guard<std::mutex> lock(resourceMutex);
+        resourceGroup* group = findGroup(shareGroup);
+        if(group == nullptr) {
+            return gpuResource();
+        }
+
+        for(resourceControl* control : group->cache) {
+            if(control->key == key) {
+                control->references++;
+                return gpuResource(control);
+            }
+        }
+        return gpuResource();
+    }
+
+    void flushResources(const void* shareGroup, GladGLContext* openglContext) {
+        std::vector<std::pair<resourceTypes, GLuint>> deletes;
+        {
+            std::lock_guard<std::mutex> lock(resourceMutex);
+            resourceGroup* group = findGroup(shareGroup);
+            if(group == nullptr || group->deletes.empty()) {
+                return;
+            }
+            deletes.swap(group->deletes);
+        }
+
+        for(const std::pair<resourceTypes, GLuint>& resource : deletes) {
+            switch(resource.first) {
+                case resourceTypes::TEXTURE:
+                    openglContext->DeleteTextures(1, &resource.second);
+                    break;
+                case resourceTypes::BUFFER:
+                    openglContext->DeleteBuffers(1, &resource.second);
+                    break;
+                case resourceTypes::PROGRAM:
+                    openglContext->DeleteProgram(resource.second);
+                    break;
+            }
+        }
+        logger.get()->debug("[PNT]Deleted {} unreferenced gpu resources", deletes.size());
+    }
+
+    void releaseResourceGroup(const void* shareGroup) {
+        std::lock_guard<std::mutex> lock(resourceMutex);
+        std::erase_if(resourceGroups, [shareGroup](const resourceGroup& group) {
+            return group.shareGroup == shareGroup;
+        });
+    }
+}
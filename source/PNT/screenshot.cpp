@@ -0,0 +1,98 @@
+#include <PNT/screenshot.hpp>
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <algorithm>
+#include <condition_variable>
+#include <spdlog/spdlog.h>
+#include <stb_image_write.h>
+#include <PNT/event.hpp>
+#include <PNT/window.hpp>
+
+namespace PNT {
+    extern std::shared_ptr<spdlog::logger> logger;
+
+    struct screenshotJob {
+        Window* window;
+        uint64_t id;
+        std::string path;
+        int width;
+        int height;
+        std::vector<unsigned char> pixels;
+    };
+
+    static std::thread screenshotThread;
+    static std::mutex screenshotMutex;
+    static std::condition_variable screenshotCondition;
+    static std::condition_variable screenshotDoneCondition;
+    static std::deque<screenshotJob> screenshotJobs;
+    static std::vector<const Window*> screenshotWindows;
+    static bool screenshotStopping = false;
+
+    void screenshotLoop() {
+        std::unique_lock<std::mutex> lock(screenshotMutex);
+        while(true) {
+            screenshotCondition.wait(lock, [] {
+                return screenshotStopping || !screenshotJobs.empty();
+            });
+            if(screenshotJobs.empty()) {
+                return;
+            }
+
+            screenshotJob job = std::move(screenshotJobs.front());
+            screenshotJobs.pop_front();
+            lock.unlock();
+
+            // A negative stride starting at the last row flips the bottom-up capture without a copy.
+            int stride = job.width * 4;
+            bool succeeded = stbi_write_png(job.path.c_str(), job.width, job.height, 4, job.pixels.data() + (size_t)stride * (job.height - 1), -stride) != 0;
+            if(succeeded) {
+                logger.get()->debug("[PNT]Wrote screenshot \"{}\"", job.path);
+            } else {
+                logger.get()->error("[PNT]Failed to write screenshot \"{}\"", job.path);
+            }
+            // Not "pushEvent()", this thread has nothing to catch its exception with if the window was closed meanwhile.
+            job.window->postEvent(createScreenshotEvent(job.id, succeeded));
+
+            lock.lock();
+            // Windows wait for this entry before freeing their event queue, so it is only removed once the event was pushed.
+            screenshotWindows.erase(std::find(screenshotWindows.begin(), screenshotWindows.end(), job.window));
+            screenshotDoneCondition.notify_all();
+        }
+    }
+
+    // Screenshot definitions.
+
+    void queueScreenshot(Window* window, uint64_t id, std::string path, int width, int height, std::vector<unsigned char>&& pixels) {
+        {
+            std::lock_guard<std::mutex> lock(screenshotMutex);
+            if(!screenshotThread.joinable()) {
+                screenshotStopping = false;
+                screenshotThread = std::thread(screenshotLoop);
+            }
+            screenshotJobs.emplace_back(screenshotJob{window, id, std::move(path), width, height, std::move(pixels)});
+            screenshotWindows.emplace_back(window);
+        }
+        screenshotCondition.notify_one();
+    }
+
+    void waitForScreenshots(const Window* window) {
+        std::unique_lock<std::mutex> lock(screenshotMutex);
+        screenshotDoneCondition.wait(lock, [window] {
+            return std::find(screenshotWindows.begin(), screenshotWindows.end(), window) == screenshotWindows.end();
+        });
+    }
+
+    void stopScreenshots() {
+        {
+            std::lock_guard<std::mutex> lock(screenshotMutex);
+            if(!screenshotThread.joinable()) {
+                return;
+            }
+            screenshotStopping = true;
+        }
+        screenshotCondition.notify_one();
+        screenshotThread.join();
+    }
+}
@@ -0,0 +1,90 @@
+#include <PNT/stats.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace PNT {
+    // Frame statistics definitions.
+
+    frameStats::frameStats(size_t capacity) : m_samples(), m_next(0), m_count(0), m_scratch() {
+        setCapacity(capacity);
+    }
+
+    void frameStats::setCapacity(size_t capacity) {
+        m_samples.assign(capacity < 1 ? 1 : capacity, frameTiming{});
+        m_scratch.reserve(m_samples.size());
+        clear();
+    }
+
+    void frameStats::addSample(const frameTiming& timing) {
+        m_samples[m_next] = timing;
+        m_next = (m_next + 1) % m_samples.size();
+        m_count = std::min(m_count + 1, m_samples.size());
+    }
+
+    void frameStats::clear() {
+        m_next = 0;
+        m_count = 0;
+    }
+
+    size_t frameStats::size() const {
+        return m_count;
+    }
+
+    size_t frameStats::capacity() const {
+        return m_samples.size();
+    }
+
+    const frameTiming& frameStats::sample(size_t age) const {
+        return m_samples[(m_next + m_samples.size() - 1 - (age % m_samples.size())) % m_samples.size()];
+    }
+
+    double frameStats::value(frameMetrics metric, size_t age) const {
+        const frameTiming& timing = sample(age);
+        switch(metric) {
+            case frameMetrics::FRAME:
+                return timing.frame;
+            case frameMetrics::CPU:
+                return timing.cpu;
+            case frameMetrics::SWAP:
+                return timing.swap;
+            case frameMetrics::EVENTS:
+                return timing.events;
+            default:
+                return 0.0;
+        }
+    }
+
+    void frameStats::gather(frameMetrics metric) const {
+        m_scratch.clear();
+        for(size_t age = 0; age < m_count; age++) {
+            m_scratch.emplace_back(value(metric, age));
+        }
+    }
+
+    double frameStats::percentile(frameMetrics metric, double percent) const {
+        if(m_count == 0) {
+            return 0.0;
+        }
+
+        gather(metric);
+        size_t rank = (size_t)std::ceil(std::clamp(percent, 0.0, 100.0) / 100.0 * (double)m_count);
+        std::vector<double>::iterator nth = m_scratch.begin() + (rank == 0 ? 0 : rank - 1);
+        std::nth_element(m_scratch.begin(), nth, m_scratch.end());
+        return *nth;
+    }
+
+    frameSummary frameStats::summary(frameMetrics metric) const {
+        if(m_count == 0) {
+            return frameSummary{};
+        }
+
+        gather(metric);
+        std::sort(m_scratch.begin(), m_scratch.end());
+        auto rank = [this](double percent) {
+            size_t index = (size_t)std::ceil(percent / 100.0 * (double)m_count);
+            return m_scratch[index == 0 ? 0 : index - 1];
+        };
+        return frameSummary{rank(50.0), rank(95.0), rank(99.0), m_scratch.back()};
+    }
+}
@@ -0,0 +1,150 @@
+#include <PNT/streamBuffer.hpp>
+
+#include <algorithm>
+#include <stdint.h>
+#include <spdlog/spdlog.h>
+
+namespace PNT {
+    extern std::shared_ptr<spdlog::logger> logger;
+
+    // Regions start big enough for typical ui frames, heavier ones grow them once and keep the size.
+    static constexpr size_t minimumRegionSize = 256 * 1024;
+    static constexpr GLbitfield persistentFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    // Stream buffer definitions.
+
+    streamBuffer::streamBuffer() : m_openglContext(nullptr), m_buffer(0), m_persistent(false), m_mapped(nullptr), m_regionSize(0), m_region(0), m_capacity(0), m_fences() {
+    }
+
+    void streamBuffer::init(GladGLContext* openglContext, bool persistent) {
+        m_openglContext = openglContext;
+        m_persistent = persistent && m_openglContext->VERSION_4_4;
+    }
+
+    void streamBuffer::shutdown() {
+        if(m_openglContext == nullptr) {
+            return;
+        }
+
+        for(GLsync& fence : m_fences) {
+            if(fence != nullptr) {
+                m_openglContext->DeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+        // Deleting a buffer unmaps it.
+        if(m_buffer != 0) {
+            m_openglContext->DeleteBuffers(1, &m_buffer);
+        }
+        m_buffer = 0;
+        m_mapped = nullptr;
+        m_regionSize = 0;
+        m_region = 0;
+        m_capacity = 0;
+        m_openglContext = nullptr;
+    }
+
+    void streamBuffer::allocatePersistent(size_t regionSize) {
+        GladGLContext* gl = m_openglContext;
+        // The old storage stays alive in the driver until the gpu is done with it, so nothing has to be waited on here.
+        for(GLsync& fence : m_fences) {
+            if(fence != nullptr) {
+                gl->DeleteSync(fence);
+                fence = nullptr;
+            }
+        }
+        if(m_buffer != 0) {
+            gl->DeleteBuffers(1, &m_buffer);
+        }
+
+        gl->GenBuffers(1, &m_buffer);
+        gl->BindBuffer(GL_ARRAY_BUFFER, m_buffer);
+        gl->BufferStorage(GL_ARRAY_BUFFER, (GLsizeiptr)(regionSize * regionCount), nullptr, persistentFlags);
+        m_mapped = static_cast<unsigned char*>(gl->MapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)(regionSize * regionCount), persistentFlags));
+        if(m_mapped == nullptr) {
+            logger.get()->warn("[PNT]Failed to persistently map a stream buffer, falling back to orphaning");
+            gl->DeleteBuffers(1, &m_buffer);
+            m_buffer = 0;
+            m_persistent = false;
+            m_regionSize = 0;
+            return;
+        }
+        m_regionSize = regionSize;
+        m_region = 0;
+        logger.get()->debug("[PNT]Allocated a {} byte persistent stream buffer", regionSize * regionCount);
+    }
+
+    void streamBuffer::waitRegion(size_t region) {
+        GLsync& fence = m_fences[region];
+        if(fence == nullptr) {
+            return;
+        }
+        // Three regions keep the gpu two submissions behind before this ever blocks, the flush makes sure a fence that is waited on was sent.
+        GLenum status = m_openglContext->ClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+        while(status == GL_TIMEOUT_EXPIRED) {
+            status = m_openglContext->ClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        }
+        m_openglContext->DeleteSync(fence);
+        fence = nullptr;
+    }
+
+    unsigned char* streamBuffer::begin(size_t size) {
+        if(m_openglContext == nullptr || size == 0) {
+            return nullptr;
+        }
+        GladGLContext* gl = m_openglContext;
+
+        if(m_persistent) {
+            if(size > m_regionSize) {
+                // Regions stay aligned so offsets into them keep the alignment of whatever the caller lays out.
+                allocatePersistent((std::max(size + size / 2, std::max(minimumRegionSize, m_regionSize * 2)) + 255) & ~(size_t)255);
+            } else {
+                m_region = (m_region + 1) % regionCount;
+                gl->BindBuffer(GL_ARRAY_BUFFER, m_buffer);
+            }
+            if(m_persistent) {
+                waitRegion(m_region);
+                return m_mapped + m_region * m_regionSize;
+            }
+        }
+
+        if(m_buffer == 0) {
+            gl->GenBuffers(1, &m_buffer);
+        }
+        gl->BindBuffer(GL_ARRAY_BUFFER, m_buffer);
+        // Specifying the same size again hands the old storage to the gpu and gives back fresh storage, so mapping never waits.
+        if(size > m_capacity) {
+            m_capacity = std::max(size + size / 2, minimumRegionSize);
+        }
+        gl->BufferData(GL_ARRAY_BUFFER, (GLsizeiptr)m_capacity, nullptr, GL_STREAM_DRAW);
+        return static_cast<unsigned char*>(gl->MapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+    }
+
+    void streamBuffer::end() {
+        // Coherent mappings need no flush, orphaned storage is unmapped.
+        if(!m_persistent) {
+            m_openglContext->UnmapBuffer(GL_ARRAY_BUFFER);
+        }
+    }
+
+    void streamBuffer::finish() {
+        if(m_persistent) {
+            if(m_fences[m_region] != nullptr) {
+                m_openglContext->DeleteSync(m_fences[m_region]);
+            }
+            m_fences[m_region] = m_openglContext->FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+    }
+
+    size_t streamBuffer::getOffset() const {
+        return m_persistent ? m_region * m_regionSize : 0;
+    }
+
+    GLuint streamBuffer::getBuffer() const {
+        return m_buffer;
+    }
+
+    bool streamBuffer::isPersistent() const {
+        return m_persistent;
+    }
+}
@@ -0,0 +1,332 @@
+#include <PNT/trace.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <spdlog/spdlog.h>
+
+namespace PNT {
+    extern std::thread::id mainThread;
+    extern std::shared_ptr<spdlog::logger> logger;
+
+    struct traceRecord {
+        const char* name;
+        int64_t begin;
+        int64_t end;
+        uint32_t thread;
+    };
+
+    struct flightDump {
+        std::string path;
+        std::vector<traceRecord> records;
+        int64_t start;
+    };
+
+    // Zones are collected per thread and handed over in batches so the hot path never takes a lock.
+    static constexpr size_t traceBatchSize = 256;
+    static constexpr size_t flightMaxPendingDumps = 4;
+
+    static std::mutex traceMutex;
+    static std::vector<std::vector<traceRecord>> traceBatches;
+    static std::vector<std::pair<uint32_t, bool>> traceThreads;
+    static std::atomic<uint32_t> traceSession = 0;
+    static std::atomic<uint32_t> traceThreadCount = 0;
+    static int64_t traceStart = 0;
+
+    // Flight recorder state, the ring is guarded by traceMutex and the frame marks are only touched by the main thread.
+    static bool flightRecording = false;
+    static std::vector<traceRecord> flightRing;
+    static size_t flightRingNext = 0;
+    static size_t flightRingCount = 0;
+    static std::vector<int64_t> flightFrames;
+    static size_t flightFrameNext = 0;
+    static size_t flightFrameCount = 0;
+    static double flightBudget = 0.0;
+    static std::string flightDirectory;
+    static uint64_t flightDumpIndex = 0;
+    static std::atomic<double> flightHitch = 0.0;
+
+    static std::thread flightWriter;
+    static std::mutex flightWriterMutex;
+    static std::condition_variable flightWriterCondition;
+    static std::deque<flightDump> flightDumps;
+    static bool flightWriterStopping = false;
+
+    struct threadTraceBuffer {
+        std::vector<traceRecord> records;
+        uint32_t session = 0;
+        uint32_t thread = 0;
+
+        threadTraceBuffer() : thread(traceThreadCount.fetch_add(1, std::memory_order_relaxed) + 1) {
+            std::lock_guard<std::mutex> lock(traceMutex);
+            traceThreads.emplace_back(thread, std::this_thread::get_id() == mainThread);
+        }
+
+        ~threadTraceBuffer() {
+            flush();
+        }
+
+        void flush() {
+            if(records.empty()) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(traceMutex);
+            // Zones from an older session are dropped rather than mixed into the current trace.
+            if(session != traceSession.load(std::memory_order_relaxed) || !tracingActive.load(std::memory_order_relaxed)) {
+                records.clear();
+            } else if(flightRecording) {
+                // The ring overwrites the oldest zones and the buffer keeps its storage, so normal frames never allocate.
+                for(const traceRecord& record : records) {
+                    flightRing[flightRingNext] = record;
+                    flightRingNext = (flightRingNext + 1) % flightRing.size();
+                    flightRingCount = std::min(flightRingCount + 1, flightRing.size());
+                }
+                records.clear();
+            } else {
+                traceBatches.emplace_back(std::move(records));
+                records = std::vector<traceRecord>();
+            }
+        }
+    };
+
+    static thread_local threadTraceBuffer traceBuffer;
+
+    static void writeTraceString(FILE* file, const char* text) {
+        std::fputc('"', file);
+        for(; *text; text++) {
+            if(*text == '"' || *text == '\\') {
+                std::fputc('\\', file);
+            }
+            if((unsigned char)*text >= 0x20) {
+                std::fputc(*text, file);
+            }
+        }
+        std::fputc('"', file);
+    }
+
+    static bool writeTrace(const std::string& path, const std::vector<std::vector<traceRecord>>& batches, const std::vector<std::pair<uint32_t, bool>>& threads, int64_t start) {
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if(file == nullptr) {
+            logger.get()->error("[PNT]Failed to open trace file \"{}\"", path);
+            return false;
+        }
+
+        std::vector<char> buffer(1 << 20);
+        std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+        std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+        bool first = true;
+        for(const std::pair<uint32_t, bool>& thread : threads) {
+            std::fprintf(file, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s %u\"}}", first ? "" : ",\n", thread.first, thread.second ? "Main" : "Thread", thread.first);
+            first = false;
+        }
+        size_t zones = 0;
+        for(const std::vector<traceRecord>& batch : batches) {
+            for(const traceRecord& record : batch) {
+                std::fputs(first ? "{\"ph\":\"X\",\"pid\":1,\"name\":" : ",\n{\"ph\":\"X\",\"pid\":1,\"name\":", file);
+                writeTraceString(file, record.name);
+                std::fprintf(file, ",\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", record.thread, (double)(record.begin - start) * 1e-3, (double)(record.end - record.begin) * 1e-3);
+                first = false;
+                zones++;
+            }
+        }
+        std::fputs("\n]}\n", file);
+        bool written = std::ferror(file) == 0;
+        written = std::fclose(file) == 0 && written;
+
+        logger.get()->info("[PNT]Wrote {} trace zones to \"{}\"", zones, path);
+        return written;
+    }
+
+    static void flightWriterLoop() {
+        std::unique_lock<std::mutex> lock(flightWriterMutex);
+        while(true) {
+            flightWriterCondition.wait(lock, [] {
+                return flightWriterStopping || !flightDumps.empty();
+            });
+            if(flightDumps.empty()) {
+                return;
+            }
+
+            flightDump dump = std::move(flightDumps.front());
+            flightDumps.pop_front();
+            lock.unlock();
+            std::vector<std::pair<uint32_t, bool>> threads;
+            {
+                std::lock_guard<std::mutex> traceLock(traceMutex);
+                threads = traceThreads;
+            }
+            std::vector<std::vector<traceRecord>> batches(1);
+            batches[0] = std::move(dump.records);
+            writeTrace(dump.path, batches, threads, dump.start);
+            lock.lock();
+        }
+    }
+
+    // Copies the frames kept by the ring into a dump and hands it to the writer thread.
+    static void dumpFlightRecorder(double hitch) {
+        flightDump dump;
+        dump.start = flightFrames[(flightFrameNext + flightFrames.size() - flightFrameCount) % flightFrames.size()];
+        {
+            std::lock_guard<std::mutex> lock(traceMutex);
+            dump.records.reserve(flightRingCount);
+            for(size_t i = 0; i < flightRingCount; i++) {
+                const traceRecord& record = flightRing[(flightRingNext + flightRing.size() - flightRingCount + i) % flightRing.size()];
+                if(record.end >= dump.start) {
+                    dump.records.emplace_back(record);
+                }
+            }
+        }
+        char name[64];
+        std::snprintf(name, sizeof(name), "/hitch-%llu-%.0fms.json", (unsigned long long)flightDumpIndex++, hitch * 1000.0);
+        dump.path = flightDirectory + name;
+
+        std::lock_guard<std::mutex> lock(flightWriterMutex);
+        if(flightDumps.size() >= flightMaxPendingDumps) {
+            logger.get()->warn("[PNT]Flight recorder is still writing older hitches, dropping \"{}\"", dump.path);
+            return;
+        }
+        flightDumps.emplace_back(std::move(dump));
+        flightWriterCondition.notify_one();
+    }
+
+    // Trace definitions.
+
+    int64_t traceClock() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void recordTraceZone(const char* name, int64_t begin, int64_t end) {
+        threadTraceBuffer& buffer = traceBuffer;
+        uint32_t session = traceSession.load(std::memory_order_relaxed);
+        if(buffer.session != session) {
+            buffer.records.clear();
+            buffer.session = session;
+        }
+        if(buffer.records.capacity() == 0) {
+            buffer.records.reserve(traceBatchSize);
+        }
+
+        buffer.records.emplace_back(traceRecord{name, begin, end, buffer.thread});
+        if(buffer.records.size() == traceBatchSize) {
+            buffer.flush();
+        }
+    }
+
+    void flushTracing() {
+        traceBuffer.flush();
+    }
+
+    void startTracing() {
+        if(isFlightRecording()) {
+            stopFlightRecorder();
+        }
+
+        std::lock_guard<std::mutex> lock(traceMutex);
+        traceBatches.clear();
+        traceStart = traceClock();
+        traceSession.fetch_add(1, std::memory_order_relaxed);
+        tracingActive.store(true, std::memory_order_release);
+        logger.get()->info("[PNT]Started tracing");
+    }
+
+    bool stopTracing(const std::string& path) {
+        if(!isTracing() || isFlightRecording()) {
+            return false;
+        }
+        flushTracing();
+        tracingActive.store(false, std::memory_order_release);
+
+        std::vector<std::vector<traceRecord>> batches;
+        std::vector<std::pair<uint32_t, bool>> threads;
+        {
+            std::lock_guard<std::mutex> lock(traceMutex);
+            batches.swap(traceBatches);
+            threads = traceThreads;
+        }
+
+        return writeTrace(path, batches, threads, traceStart);
+    }
+
+    bool startFlightRecorder(const std::string& directory, double budget, size_t frames, size_t zonesPerFrame) {
+        if(isTracing() || frames == 0 || zonesPerFrame == 0) {
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(traceMutex);
+            flightRing.assign(frames * zonesPerFrame, traceRecord{});
+            flightRingNext = 0;
+            flightRingCount = 0;
+            flightRecording = true;
+            traceSession.fetch_add(1, std::memory_order_relaxed);
+        }
+        flightFrames.assign(frames, traceClock());
+        flightFrameNext = 0;
+        flightFrameCount = 1;
+        flightBudget = budget;
+        flightDirectory = directory;
+        flightHitch.store(0.0, std::memory_order_relaxed);
+        flightWriterStopping = false;
+        flightWriter = std::thread(flightWriterLoop);
+        tracingActive.store(true, std::memory_order_release);
+
+        logger.get()->info("[PNT]Started flight recorder, frames over {}ms are written to \"{}\"", budget * 1000.0, directory);
+        return true;
+    }
+
+    void stopFlightRecorder() {
+        if(!isFlightRecording()) {
+            return;
+        }
+        tracingActive.store(false, std::memory_order_release);
+
+        {
+            std::lock_guard<std::mutex> lock(flightWriterMutex);
+            flightWriterStopping = true;
+        }
+        flightWriterCondition.notify_one();
+        flightWriter.join();
+
+        std::lock_guard<std::mutex> lock(traceMutex);
+        flightRecording = false;
+        flightRing = std::vector<traceRecord>();
+        flightFrames = std::vector<int64_t>();
+        logger.get()->info("[PNT]Stopped flight recorder");
+    }
+
+    bool isFlightRecording() {
+        return flightWriter.joinable();
+    }
+
+    void markTraceFrame() {
+        if(!isFlightRecording()) {
+            return;
+        }
+
+        flushTracing();
+        double hitch = flightHitch.exchange(0.0, std::memory_order_relaxed);
+        if(hitch > 0.0) {
+            dumpFlightRecorder(hitch);
+        }
+
+        flightFrames[flightFrameNext] = traceClock();
+        flightFrameNext = (flightFrameNext + 1) % flightFrames.size();
+        flightFrameCount = std::min(flightFrameCount + 1, flightFrames.size());
+    }
+
+    void traceFrameTime(double seconds) {
+        if(!isFlightRecording() || seconds <= flightBudget) {
+            return;
+        }
+
+        // The dump waits for the next frame mark so the zones closing the slow frame make it in.
+        double hitch = flightHitch.load(std::memory_order_relaxed);
+        while(seconds > hitch && !flightHitch.compare_exchange_weak(hitch, seconds, std::memory_order_relaxed)) {
+        }
+    }
+}
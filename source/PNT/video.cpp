@@ -0,0 +1,358 @@
+#include <PNT/video.hpp>
+
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include <stb_image_write.h>
+#include <PNT/capture.hpp>
+#include <PNT/window.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PNT_VIDEO_SSE2
+#endif
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+namespace PNT {
+    extern std::shared_ptr<spdlog::logger> logger;
+
+    // BT.601 limited range, the same integer math is used by the scalar and the SSE2 paths so both produce identical frames.
+
+    static inline unsigned char lumaOf(int red, int green, int blue) {
+        return (unsigned char)(((66 * red + 129 * green + 25 * blue + 128) >> 8) + 16);
+    }
+
+    static inline unsigned char chromaBlueOf(int red, int green, int blue) {
+        return (unsigned char)(((-38 * red - 74 * green + 112 * blue + 128) >> 8) + 128);
+    }
+
+    static inline unsigned char chromaRedOf(int red, int green, int blue) {
+        return (unsigned char)(((112 * red - 94 * green - 18 * blue + 128) >> 8) + 128);
+    }
+
+    static inline int average(int first, int second) {
+        return (first + second + 1) >> 1;
+    }
+
+#ifdef PNT_VIDEO_SSE2
+    // Weighs the channels of 4 RGBA pixels, the result holds one 32 bit sum per pixel.
+    static inline __m128i weighPixels(__m128i pixels, __m128i coefficients) {
+        __m128i zero = _mm_setzero_si128();
+        __m128i low = _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), coefficients);
+        __m128i high = _mm_madd_epi16(_mm_unpackhi_epi8(pixels, zero), coefficients);
+        __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high), _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(low), _mm_castsi128_ps(high), _MM_SHUFFLE(3, 1, 3, 1));
+        return _mm_add_epi32(_mm_castps_si128(even), _mm_castps_si128(odd));
+    }
+
+    static inline __m128i scaleSums(__m128i sums, __m128i offset) {
+        return _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(sums, _mm_set1_epi32(128)), 8), offset);
+    }
+#endif
+
+    // Converts bottom-up RGBA rows (as read by glReadPixels) into top-down I420 planes.
+    static void convertToI420(const unsigned char* rgba, int width, int height, unsigned char* planes) {
+        size_t stride = (size_t)width * 4;
+        int chromaWidth = (width + 1) / 2;
+        int chromaHeight = (height + 1) / 2;
+        unsigned char* lumaPlane = planes;
+        unsigned char* bluePlane = planes + (size_t)width * height;
+        unsigned char* redPlane = bluePlane + (size_t)chromaWidth * chromaHeight;
+
+        for(int y = 0; y < height; y++) {
+            const unsigned char* row = rgba + stride * (height - 1 - y);
+            unsigned char* luma = lumaPlane + (size_t)width * y;
+            int x = 0;
+#ifdef PNT_VIDEO_SSE2
+            const __m128i coefficients = _mm_setr_epi16(66, 129, 25, 0, 66, 129, 25, 0);
+            const __m128i offset = _mm_set1_epi32(16);
+            for(; x + 16 <= width; x += 16) {
+                const __m128i* source = reinterpret_cast<const __m128i*>(row + x * 4);
+                __m128i first = scaleSums(weighPixels(_mm_loadu_si128(source), coefficients), offset);
+                __m128i second = scaleSums(weighPixels(_mm_loadu_si128(source + 1), coefficients), offset);
+                __m128i third = scaleSums(weighPixels(_mm_loadu_si128(source + 2), coefficients), offset);
+                __m128i fourth = scaleSums(weighPixels(_mm_loadu_si128(source + 3), coefficients), offset);
+                __m128i packed = _mm_packus_epi16(_mm_packs_epi32(first, second), _mm_packs_epi32(third, fourth));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(luma + x), packed);
+            }
+#endif
+            for(; x < width; x++) {
+                luma[x] = lumaOf(row[x * 4], row[x * 4 + 1], row[x * 4 + 2]);
+            }
+        }
+
+        for(int y = 0; y < chromaHeight; y++) {
+            const unsigned char* top = rgba + stride * (height - 1 - y * 2);
+            const unsigned char* bottom = y * 2 + 1 < height ? top - stride : top;
+            unsigned char* blue = bluePlane + (size_t)chromaWidth * y;
+            unsigned char* red = redPlane + (size_t)chromaWidth * y;
+            int x = 0;
+#ifdef PNT_VIDEO_SSE2
+            const __m128i blueCoefficients = _mm_setr_epi16(-38, -74, 112, 0, -38, -74, 112, 0);
+            const __m128i redCoefficients = _mm_setr_epi16(112, -94, -18, 0, 112, -94, -18, 0);
+            const __m128i offset = _mm_set1_epi32(128);
+            for(; x + 8 <= width; x += 8) {
+                const __m128i* topSource = reinterpret_cast<const __m128i*>(top + x * 4);
+                const __m128i* bottomSource = reinterpret_cast<const __m128i*>(bottom + x * 4);
+                __m128i left = _mm_avg_epu8(_mm_loadu_si128(topSource), _mm_loadu_si128(bottomSource));
+                __m128i right = _mm_avg_epu8(_mm_loadu_si128(topSource + 1), _mm_loadu_si128(bottomSource + 1));
+                __m128 even = _mm_shuffle_ps(_mm_castsi128_ps(left), _mm_castsi128_ps(right), _MM_SHUFFLE(2, 0, 2, 0));
+                __m128 odd = _mm_shuffle_ps(_mm_castsi128_ps(left), _mm_castsi128_ps(right), _MM_SHUFFLE(3, 1, 3, 1));
+                __m128i pixels = _mm_avg_epu8(_mm_castps_si128(even), _mm_castps_si128(odd));
+                __m128i chroma = _mm_packs_epi32(scaleSums(weighPixels(pixels, blueCoefficients), offset), scaleSums(weighPixels(pixels, redCoefficients), offset));
+                chroma = _mm_packus_epi16(chroma, chroma);
+                int blueBytes = _mm_cvtsi128_si32(chroma);
+                int redBytes = _mm_cvtsi128_si32(_mm_srli_si128(chroma, 4));
+                std::memcpy(blue + x / 2, &blueBytes, 4);
+                std::memcpy(red + x / 2, &redBytes, 4);
+            }
+#endif
+            for(; x < width; x += 2) {
+                int next = x + 1 < width ? x + 1 : x;
+                int channels[3];
+                for(int channel = 0; channel < 3; channel++) {
+                    channels[channel] = average(average(top[x * 4 + channel], bottom[x * 4 + channel]), average(top[next * 4 + channel], bottom[next * 4 + channel]));
+                }
+                blue[x / 2] = chromaBlueOf(channels[0], channels[1], channels[2]);
+                red[x / 2] = chromaRedOf(channels[0], channels[1], channels[2]);
+            }
+        }
+    }
+
+    // Video recorder definitions.
+
+    videoRecorder::videoRecorder() : m_format(videoFormats::Y4M), m_file(nullptr), m_pipe(false), m_fps(60), m_width(0), m_height(0), m_sequence(0), m_dropped(0), m_written(0), m_failed(false), m_stopping(false) {
+    }
+
+    videoRecorder::~videoRecorder() {
+        stop();
+    }
+
+    bool videoRecorder::start(const std::string& path, videoFormats format, int fps, size_t maxBufferedFrames, unsigned int workers) {
+        if(isRecording() || path.empty()) {
+            return false;
+        }
+
+        m_pipe = false;
+        m_file = nullptr;
+        if(format != videoFormats::PNG) {
+            if(path == "-") {
+                m_file = stdout;
+            } else if(path[0] == '|') {
+                m_file = popen(path.c_str() + 1, "w");
+                m_pipe = true;
+            } else {
+                m_file = std::fopen(path.c_str(), "wb");
+            }
+            if(m_file == nullptr) {
+                logger.get()->error("[PNT]Failed to open video output \"{}\"", path);
+                return false;
+            }
+        }
+
+        m_path = path;
+        m_format = format;
+        m_fps = fps > 0 ? fps : 60;
+        m_width = 0;
+        m_height = 0;
+        m_sequence = 0;
+        m_dropped = 0;
+        m_written = 0;
+        m_failed = false;
+        m_stopping = false;
+
+        // Every buffer is allocated up front (sized on first use), so memory stays bounded however far the workers fall behind.
+        m_jobs.clear();
+        m_free.clear();
+        for(size_t i = 0; i < (maxBufferedFrames ? maxBufferedFrames : 1); i++) {
+            m_jobs.emplace_back(std::make_unique<videoJob>());
+            m_free.emplace_back(m_jobs.back().get());
+        }
+
+        for(unsigned int i = 0; i < (workers ? workers : 1); i++) {
+            m_workers.emplace_back(&videoRecorder::workerLoop, this);
+        }
+        m_writer = std::thread(&videoRecorder::writerLoop, this);
+
+        logger.get()->info("[PNT]Started recording video to \"{}\"", path);
+        return true;
+    }
+
+    void videoRecorder::stop() {
+        if(!isRecording()) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_convertCondition.notify_all();
+        m_writeCondition.notify_all();
+        for(std::thread& worker : m_workers) {
+            worker.join();
+        }
+        m_workers.clear();
+        m_writer.join();
+
+        if(m_file != nullptr && m_file != stdout) {
+            m_pipe ? pclose(m_file) : std::fclose(m_file);
+        } else if(m_file == stdout) {
+            std::fflush(stdout);
+        }
+        m_file = nullptr;
+        m_jobs.clear();
+        m_free.clear();
+
+        logger.get()->info("[PNT]Stopped recording video to \"{}\" ({} frames written, {} dropped)", m_path, m_written.load(), m_dropped.load());
+    }
+
+    bool videoRecorder::isRecording() const {
+        return m_writer.joinable();
+    }
+
+    bool videoRecorder::submit(const capturedFrame& frame) {
+        if(!isRecording() || m_failed.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        if(m_format != videoFormats::PNG) {
+            if(m_width == 0) {
+                m_width = frame.width;
+                m_height = frame.height;
+            } else if(frame.width != m_width || frame.height != m_height) {
+                m_dropped++;
+                return false;
+            }
+        }
+
+        videoJob* job;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if(m_free.empty()) {
+                m_dropped++;
+                return false;
+            }
+            job = m_free.back();
+            m_free.pop_back();
+        }
+
+        job->sequence = m_sequence++;
+        job->frame = frame.frame;
+        job->width = frame.width;
+        job->height = frame.height;
+        job->done = false;
+        job->pixels.assign(frame.pixels.begin(), frame.pixels.end());
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_convertQueue.emplace_back(job);
+            m_inFlight.emplace_back(job);
+        }
+        m_convertCondition.notify_one();
+        return true;
+    }
+
+    void videoRecorder::convert(videoJob& job) {
+        switch(m_format) {
+            case videoFormats::Y4M:
+                job.converted.resize((size_t)job.width * job.height + (size_t)((job.width + 1) / 2) * ((job.height + 1) / 2) * 2);
+                convertToI420(job.pixels.data(), job.width, job.height, job.converted.data());
+                break;
+            case videoFormats::PNG: {
+                char path[1024];
+                std::snprintf(path, sizeof(path), m_path.c_str(), (unsigned long long)job.frame);
+                int stride = job.width * 4;
+                // A negative stride starting at the last row flips the bottom-up capture without a copy.
+                if(!stbi_write_png(path, job.width, job.height, 4, job.pixels.data() + (size_t)stride * (job.height - 1), -stride)) {
+                    logger.get()->error("[PNT]Failed to write \"{}\"", path);
+                }
+                break;
+            }
+            default:
+                break;
+        }
+    }
+
+    void videoRecorder::workerLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while(true) {
+            m_convertCondition.wait(lock, [this] {
+                return m_stopping || !m_convertQueue.empty();
+            });
+            if(m_convertQueue.empty()) {
+                return;
+            }
+
+            videoJob* job = m_convertQueue.front();
+            m_convertQueue.pop_front();
+            lock.unlock();
+            convert(*job);
+            lock.lock();
+            job->done = true;
+            m_writeCondition.notify_one();
+        }
+    }
+
+    void videoRecorder::writerLoop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while(true) {
+            // Workers finish out of order, the stream is written in submission order.
+            m_writeCondition.wait(lock, [this] {
+                return (!m_inFlight.empty() && m_inFlight.front()->done) || (m_stopping && m_inFlight.empty());
+            });
+            if(m_inFlight.empty()) {
+                return;
+            }
+
+            videoJob* job = m_inFlight.front();
+            m_inFlight.pop_front();
+            lock.unlock();
+
+            bool written = true;
+            if(m_format == videoFormats::Y4M) {
+                if(job->sequence == 0) {
+                    written = std::fprintf(m_file, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n", job->width, job->height, m_fps) > 0;
+                }
+                written = written && std::fputs("FRAME\n", m_file) >= 0;
+                written = written && std::fwrite(job->converted.data(), 1, job->converted.size(), m_file) == job->converted.size();
+            } else if(m_format == videoFormats::RAW_RGBA) {
+                size_t stride = (size_t)job->width * 4;
+                for(int y = job->height - 1; y >= 0 && written; y--) {
+                    written = std::fwrite(job->pixels.data() + stride * y, 1, stride, m_file) == stride;
+                }
+            }
+            if(!written && !m_failed.exchange(true)) {
+                logger.get()->error("[PNT]Failed to write video to \"{}\", dropping the remaining frames", m_path);
+            }
+            m_written += written ? 1 : 0;
+
+            lock.lock();
+            m_free.emplace_back(job);
+        }
+    }
+
+    void videoRecorder::attach(Window* window) {
+        window->setCaptureCallback(captureCallback, this);
+        window->setContinuousCapture(true);
+    }
+
+    void videoRecorder::detach(Window* window) {
+        window->setContinuousCapture(false);
+        window->setCaptureCallback(nullptr, nullptr);
+    }
+
+    uint64_t videoRecorder::getDropped() const {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    uint64_t videoRecorder::getWritten() const {
+        return m_written.load(std::memory_order_relaxed);
+    }
+
+    void videoRecorder::captureCallback(Window*, const capturedFrame& frame, void* recorder) {
+        static_cast<videoRecorder*>(recorder)->submit(frame);
+    }
+}
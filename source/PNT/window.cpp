@@ -1,28 +1,197 @@
 #include <PNT/window.hpp>
 
 #include <algorithm>
+#include <cfloat>
+#include <cstdio>
+#include <cstring>
+#include <thread>
 #include <spdlog/spdlog.h>
 #include <imgui.h>
 #include <misc/cpp/imgui_stdlib.h>
 #include <backends/imgui_impl_glfw.h>
-#include <backends/imgui_impl_opengl3.h>
+#include <stb_image.h>
 #include <PNT/error.hpp>
 #include <PNT/event.hpp>
+#include <PNT/record.hpp>
+#include <PNT/allocations.hpp>
+#include <PNT/screenshot.hpp>
+#include <PNT/trace.hpp>
 
 namespace PNT {
     extern bool initialized;
+    extern std::thread::id mainThread;
     extern std::shared_ptr<spdlog::logger> logger;
 
+    // Feeds the frame time history to imgui's plots, oldest frame first.
+    struct overlayPlot {
+        const frameStats* stats;
+        bool rate;
+    };
+
+    static float overlayPlotValue(void* data, int index) {
+        const overlayPlot* plot = static_cast<const overlayPlot*>(data);
+        double frameTime = plot->stats->value(frameMetrics::FRAME, plot->stats->size() - 1 - (size_t)index);
+        if(plot->rate) {
+            return frameTime > 0.0 ? (float)(1.0 / frameTime) : 0.0f;
+        }
+        return (float)(frameTime * 1000.0);
+    }
+
+    // Hashes everything that ends up on screen so unchanged frames can be detected without comparing buffers.
+    static uint64_t hashDrawData(const ImDrawData* drawData, int width, int height) {
+        uint64_t hash = 0x9E3779B97F4A7C15ull ^ ((uint64_t)width << 32) ^ (uint64_t)height;
+        auto mix = [&hash](const void* data, size_t size) {
+            const unsigned char* bytes = static_cast<const unsigned char*>(data);
+            uint64_t word;
+            for(; size >= sizeof(word); size -= sizeof(word), bytes += sizeof(word)) {
+                std::memcpy(&word, bytes, sizeof(word));
+                hash = (hash ^ (word * 0xFF51AFD7ED558CCDull)) * 0xC4CEB9FE1A85EC53ull;
+                hash ^= hash >> 29;
+            }
+            word = size;
+            std::memcpy(&word, bytes, size);
+            hash = (hash ^ (word * 0xFF51AFD7ED558CCDull)) * 0xC4CEB9FE1A85EC53ull;
+        };
+
+        if(drawData == nullptr) {
+            return hash;
+        }
+        mix(&drawData->DisplayPos, sizeof(drawData->DisplayPos));
+        mix(&drawData->DisplaySize, sizeof(drawData->DisplaySize));
+        mix(&drawData->FramebufferScale, sizeof(drawData->FramebufferScale));
+        for(int i = 0; i < drawData->CmdListsCount; i++) {
+            const ImDrawList* drawList = drawData->CmdLists[i];
+            mix(drawList->CmdBuffer.Data, drawList->CmdBuffer.size_in_bytes());
+            mix(drawList->VtxBuffer.Data, drawList->VtxBuffer.size_in_bytes());
+            mix(drawList->IdxBuffer.Data, drawList->IdxBuffer.size_in_bytes());
+        }
+        return hash;
+    }
+
+    // Same mapping as the glfw backend, which keeps its own private, headless windows feed keys to imgui without it.
+    static ImGuiKey glfwKeyToImGuiKey(int key) {
+        if(key >= GLFW_KEY_A && key <= GLFW_KEY_Z) {
+            return (ImGuiKey)(ImGuiKey_A + (key - GLFW_KEY_A));
+        }
+        if(key >= GLFW_KEY_0 && key <= GLFW_KEY_9) {
+            return (ImGuiKey)(ImGuiKey_0 + (key - GLFW_KEY_0));
+        }
+        if(key >= GLFW_KEY_KP_0 && key <= GLFW_KEY_KP_9) {
+            return (ImGuiKey)(ImGuiKey_Keypad0 + (key - GLFW_KEY_KP_0));
+        }
+        if(key >= GLFW_KEY_F1 && key <= GLFW_KEY_F12) {
+            return (ImGuiKey)(ImGuiKey_F1 + (key - GLFW_KEY_F1));
+        }
+        switch(key) {
+            case GLFW_KEY_TAB:
+                return ImGuiKey_Tab;
+            case GLFW_KEY_LEFT:
+                return ImGuiKey_LeftArrow;
+            case GLFW_KEY_RIGHT:
+                return ImGuiKey_RightArrow;
+            case GLFW_KEY_UP:
+                return ImGuiKey_UpArrow;
+            case GLFW_KEY_DOWN:
+                return ImGuiKey_DownArrow;
+            case GLFW_KEY_PAGE_UP:
+                return ImGuiKey_PageUp;
+            case GLFW_KEY_PAGE_DOWN:
+                return ImGuiKey_PageDown;
+            case GLFW_KEY_HOME:
+                return ImGuiKey_Home;
+            case GLFW_KEY_END:
+                return ImGuiKey_End;
+            case GLFW_KEY_INSERT:
+                return ImGuiKey_Insert;
+            case GLFW_KEY_DELETE:
+                return ImGuiKey_Delete;
+            case GLFW_KEY_BACKSPACE:
+                return ImGuiKey_Backspace;
+            case GLFW_KEY_SPACE:
+                return ImGuiKey_Space;
+            case GLFW_KEY_ENTER:
+                return ImGuiKey_Enter;
+            case GLFW_KEY_ESCAPE:
+                return ImGuiKey_Escape;
+            case GLFW_KEY_APOSTROPHE:
+                return ImGuiKey_Apostrophe;
+            case GLFW_KEY_COMMA:
+                return ImGuiKey_Comma;
+            case GLFW_KEY_MINUS:
+                return ImGuiKey_Minus;
+            case GLFW_KEY_PERIOD:
+                return ImGuiKey_Period;
+            case GLFW_KEY_SLASH:
+                return ImGuiKey_Slash;
+            case GLFW_KEY_SEMICOLON:
+                return ImGuiKey_Semicolon;
+            case GLFW_KEY_EQUAL:
+                return ImGuiKey_Equal;
+            case GLFW_KEY_LEFT_BRACKET:
+                return ImGuiKey_LeftBracket;
+            case GLFW_KEY_BACKSLASH:
+                return ImGuiKey_Backslash;
+            case GLFW_KEY_RIGHT_BRACKET:
+                return ImGuiKey_RightBracket;
+            case GLFW_KEY_GRAVE_ACCENT:
+                return ImGuiKey_GraveAccent;
+            case GLFW_KEY_CAPS_LOCK:
+                return ImGuiKey_CapsLock;
+            case GLFW_KEY_SCROLL_LOCK:
+                return ImGuiKey_ScrollLock;
+            case GLFW_KEY_NUM_LOCK:
+                return ImGuiKey_NumLock;
+            case GLFW_KEY_PRINT_SCREEN:
+                return ImGuiKey_PrintScreen;
+            case GLFW_KEY_PAUSE:
+                return ImGuiKey_Pause;
+            case GLFW_KEY_KP_DECIMAL:
+                return ImGuiKey_KeypadDecimal;
+            case GLFW_KEY_KP_DIVIDE:
+                return ImGuiKey_KeypadDivide;
+            case GLFW_KEY_KP_MULTIPLY:
+                return ImGuiKey_KeypadMultiply;
+            case GLFW_KEY_KP_SUBTRACT:
+                return ImGuiKey_KeypadSubtract;
+            case GLFW_KEY_KP_ADD:
+                return ImGuiKey_KeypadAdd;
+            case GLFW_KEY_KP_ENTER:
+                return ImGuiKey_KeypadEnter;
+            case GLFW_KEY_KP_EQUAL:
+                return ImGuiKey_KeypadEqual;
+            case GLFW_KEY_LEFT_SHIFT:
+                return ImGuiKey_LeftShift;
+            case GLFW_KEY_LEFT_CONTROL:
+                return ImGuiKey_LeftCtrl;
+            case GLFW_KEY_LEFT_ALT:
+                return ImGuiKey_LeftAlt;
+            case GLFW_KEY_LEFT_SUPER:
+                return ImGuiKey_LeftSuper;
+            case GLFW_KEY_RIGHT_SHIFT:
+                return ImGuiKey_RightShift;
+            case GLFW_KEY_RIGHT_CONTROL:
+                return ImGuiKey_RightCtrl;
+            case GLFW_KEY_RIGHT_ALT:
+                return ImGuiKey_RightAlt;
+            case GLFW_KEY_RIGHT_SUPER:
+                return ImGuiKey_RightSuper;
+            case GLFW_KEY_MENU:
+                return ImGuiKey_Menu;
+            default:
+                return ImGuiKey_None;
+        }
+    }
+
     // Window definitions.
 
-    Window::Window() : m_window(nullptr), m_closed(true), m_frame(false), m_data(), m_eventQueue(), m_ImContext(nullptr), m_IO(nullptr) {
+    Window::Window() : m_window(nullptr), m_closed(true), m_frame(false), m_data(), m_eventQueue(), m_coalescedEvents(), m_coalescedCount(0), m_ImContext(nullptr), m_IO(nullptr) {
     }
 
-    Window::Window(const std::string& title, int width, int height, int xpos, int ypos, int ImGuiFlags) : m_window(nullptr), m_closed(true), m_frame(false), m_data(), m_eventQueue(), m_ImContext(nullptr), m_IO(nullptr) {
+    Window::Window(const std::string& title, int width, int height, int xpos, int ypos, int ImGuiFlags) : m_window(nullptr), m_closed(true), m_frame(false), m_data(), m_eventQueue(), m_coalescedEvents(), m_coalescedCount(0), m_ImContext(nullptr), m_IO(nullptr) {
         createWindow(title, width, height, xpos, ypos, ImGuiFlags);
     }
 
-    Window::Window(const windowData& data) : m_window(nullptr), m_closed(true), m_frame(false), m_data(), m_eventQueue(), m_ImContext(nullptr), m_IO(nullptr) {
+    Window::Window(const windowData& data) : m_window(nullptr), m_closed(true), m_frame(false), m_data(), m_eventQueue(), m_coalescedEvents(), m_coalescedCount(0), m_ImContext(nullptr), m_IO(nullptr) {
         createWindow(data);
     }
 
@@ -35,27 +204,43 @@ namespace PNT {
             throw exception("Pentagram not initalized.", errorCodes::PNT_ERROR);
         }
 
+        // Every window shares its opengl objects with this hidden one, so they outlive any single window and are only created once.
+        if(m_shareWindow == nullptr) {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            m_shareWindow = glfwCreateWindow(1, 1, "PNT share context", NULL, NULL);
+            glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+            if(m_shareWindow == nullptr) {
+                throw exception("Failed to create the shared opengl context.", errorCodes::PNT_ERROR);
+            }
+        }
+
         m_openglContext = new GladGLContext;
 
         logger.get()->info("[PNT]Creating window \"{}\"", title);
 
         m_instancesList.emplace_back(this);
+        m_creationId = m_createdWindows++;
         m_instances++;
 
         this->m_data.title = title;
         m_data.width = width;
         m_data.height = height;
         m_data.ImGuiFlags = ImGuiFlags;
+        m_eventQueue.allocate(m_data.eventQueueSize);
 
         // Intel integrted graphics no likie-like these lines
         // glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
         // glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
         // glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
-        m_window = glfwCreateWindow(width, height, title.c_str(), NULL, NULL);
+        m_window = glfwCreateWindow(width, height, title.c_str(), NULL, m_shareWindow);
         glfwSetWindowUserPointer(m_window, this);
-        glfwMakeContextCurrent(m_window);
+        makeContextCurrent();
         gladLoadGLContext(m_openglContext, (GLADloadfunc)glfwGetProcAddress);
+        m_gpuProfiler.init(m_openglContext);
+        m_capture.init(m_openglContext);
+        m_screenshotCapture.init(m_openglContext);
+        m_screenshotCapture.setCallback(screenshotCallback, nullptr);
 
         glfwSetKeyCallback(m_window, callbackManagers::keyCallbackManager);
         glfwSetCharCallback(m_window, callbackManagers::charCallbackManager);
@@ -71,26 +256,72 @@ namespace PNT {
         //glfwSetWindowCloseCallback(m_window, callbackManagers::);
         glfwSetWindowFocusCallback(m_window, callbackManagers::windowFocusCallback);
         glfwSetWindowIconifyCallback(m_window, callbackManagers::iconifyCallbackManager);
-        //glfwSetWindowRefreshCallback(m_window, callbackManagers::);
+        glfwSetWindowRefreshCallback(m_window, callbackManagers::windowRefreshCallbackManager);
         //glfwSetWindowMaximizeCallback(m_window, callbackManagers::);
         //glfwSetFramebufferSizeCallback(m_window, callbackManagers::);
         //glfwSetWindowContentScaleCallback(m_window, callbackManagers::);
 
-        m_ImContext = ImGui::CreateContext();
+        m_ImContext = ImGui::CreateContext(getSharedFontAtlas());
         ImGui::SetCurrentContext(m_ImContext);
         m_IO = &ImGui::GetIO();
         m_IO->ConfigFlags |= ImGuiFlags;
         ImGui_ImplGlfw_InitForOpenGL(m_window, false);
-        ImGui_ImplOpenGL3_Init(nullptr);
+        m_imguiRenderer.init(m_openglContext, m_shareWindow);
         ImGui::StyleColorsDark();
 
         setFocused();
         setPosition(xpos, ypos);
         m_closed = false;
+
+        if(isRenderThreadRunning() && canRenderThreaded()) {
+            attachRenderThread(this);
+        }
+    }
+
+    void Window::createHeadlessIntern(const std::string& title, int width, int height, int ImGuiFlags) {
+        if(!initialized) {
+            throw exception("Pentagram not initalized.", errorCodes::PNT_ERROR);
+        }
+
+        logger.get()->info("[PNT]Creating headless window \"{}\"", title);
+
+        m_openglContext = new GladGLContext;
+        m_headless = createHeadlessSurface(width, height, m_openglContext);
+        if(m_headless == nullptr) {
+            delete m_openglContext;
+            throw exception("Failed to create headless window.", errorCodes::PNT_ERROR);
+        }
+        m_gpuProfiler.init(m_openglContext);
+        m_capture.init(m_openglContext);
+        m_screenshotCapture.init(m_openglContext);
+        m_screenshotCapture.setCallback(screenshotCallback, nullptr);
+
+        m_instancesList.emplace_back(this);
+        m_creationId = m_createdWindows++;
+        m_instances++;
+
+        this->m_data.title = title;
+        m_data.width = width;
+        m_data.height = height;
+        m_data.ImGuiFlags = ImGuiFlags;
+        m_data.headless = true;
+        m_headlessShouldClose = false;
+        m_eventQueue.allocate(m_data.eventQueueSize);
+
+        // Without a platform backend "startFrame()" provides the display size and time, and injected events provide the input.
+        m_ImContext = ImGui::CreateContext(getSharedFontAtlas());
+        ImGui::SetCurrentContext(m_ImContext);
+        m_IO = &ImGui::GetIO();
+        m_IO->ConfigFlags |= ImGuiFlags & ~ImGuiConfigFlags_ViewportsEnable;
+        m_IO->IniFilename = nullptr;
+        m_imguiRenderer.init(m_openglContext, getHeadlessShareGroup());
+        ImGui::StyleColorsDark();
+
+        m_closed = false;
     }
 
     void Window::createWindow(const std::string& title, int width, int height, int xpos, int ypos, int ImGuiFlags) {
-        if(m_window != nullptr) {
+        if(m_window != nullptr || m_headless != nullptr) {
             throw exception("Window already initalized.", errorCodes::PNT_ERROR);
         }
 
@@ -98,12 +329,19 @@ namespace PNT {
     }
 
     void Window::createWindow(const windowData& data) {
-        if(m_window != nullptr) {
+        if(m_window != nullptr || m_headless != nullptr) {
             throw exception("Window already initalized.", errorCodes::PNT_ERROR);
         }
 
-        createWindowIntern(data.title.c_str(), data.width, data.height, data.xpos, data.ypos, data.ImGuiFlags);
+        m_data.eventQueueSize = data.eventQueueSize;
+        m_data.coalesceMode = data.coalesceMode;
+        if(data.headless) {
+            createHeadlessIntern(data.title, data.width, data.height, data.ImGuiFlags);
+        } else {
+            createWindowIntern(data.title.c_str(), data.width, data.height, data.xpos, data.ypos, data.ImGuiFlags);
+        }
         setEventCallback(data.eventCallback);
+        setEventBatchCallback(data.eventBatchCallback);
         if(data.focused) {
             setFocused();
         }
@@ -118,6 +356,9 @@ namespace PNT {
             maximize();
         }
         setVsyncMode(data.vsyncMode);
+        setRenderMode(data.renderMode);
+        setTargetFPS(data.targetFPS);
+        setPerformanceOverlay(data.performanceOverlay);
         setClearColor(data.clearColor[0], data.clearColor[1], data.clearColor[2], data.clearColor[3]);
         setUserPointer(data.userPointer);
     }
@@ -129,8 +370,42 @@ namespace PNT {
             m_instances--;
             m_instancesList.erase(std::find(m_instancesList.begin(), m_instancesList.end(), this));
 
-            glfwDestroyWindow(m_window);
+            // The render thread can still capture a frame and queue its screenshot, so it lets go of the window first.
+            detachRenderThread(this);
+            // The screenshot thread pushes its completion events into the queue freed below.
+            waitForScreenshots(this);
+            makeContextCurrent();
+            flushResources(getShareGroup(), m_openglContext);
+            // The windowed group lives on in the hidden share window, the headless one dies with its last window.
+            if(m_headless != nullptr && std::none_of(m_instancesList.begin(), m_instancesList.end(), [](const Window* window) { return window->m_headless != nullptr; })) {
+                releaseResourceGroup(getShareGroup());
+            }
+            m_gpuProfiler.shutdown();
+            m_capture.shutdown();
+            m_screenshotCapture.shutdown();
+            m_screenshots.clear();
+            ImGui::SetCurrentContext(m_ImContext);
+            m_imguiRenderer.shutdown();
+            if(m_headless != nullptr) {
+                ImGui::DestroyContext(m_ImContext);
+                destroyHeadlessSurface(m_headless);
+                m_headless = nullptr;
+            } else {
+                ImGui_ImplGlfw_Shutdown();
+                ImGui::DestroyContext(m_ImContext);
+                glfwDestroyWindow(m_window);
+            }
+            m_ImContext = nullptr;
+            m_IO = nullptr;
+            if(m_currentWindow == this) {
+                m_currentWindow = nullptr;
+            }
             delete m_openglContext;
+            m_eventQueue.free();
+            m_eventBatch.clear();
+            m_eventSamples.clear();
+            m_dropStorage.clear();
+            m_coalescedCount = 0;
 
             m_window = nullptr;
             m_closed = true;
@@ -138,68 +413,608 @@ namespace PNT {
     }
 
     void Window::startFrame() {
+        traceZone zone("Window::startFrame");
         newframe = std::chrono::steady_clock::now();
 
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
         if(m_frame) {
             throw exception("Newframe already called.", errorCodes::PNT_ERROR);
         }
 
-        glfwMakeContextCurrent(m_window);
+        m_frameInterval = m_lastFrameStart == std::chrono::steady_clock::time_point() ? std::chrono::duration<double>(0.0) : newframe - m_lastFrameStart;
+        m_lastFrameStart = newframe;
+
+        prepareSharedFontAtlas();
+        if(!m_threaded) {
+            makeContextCurrent();
+            beginGpuFrame();
+        }
         ImGui::SetCurrentContext(m_ImContext);
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
+        if(m_headless != nullptr) {
+            resizeHeadlessSurface(m_headless, m_data.width, m_data.height);
+            m_openglContext->BindFramebuffer(GL_FRAMEBUFFER, getHeadlessFramebuffer(m_headless));
+            m_IO->DisplaySize = ImVec2((float)m_data.width, (float)m_data.height);
+            m_IO->DisplayFramebufferScale = ImVec2(1.0f, 1.0f);
+            m_IO->DeltaTime = m_frameInterval.count() > 0.0 ? (float)m_frameInterval.count() : 1.0f / 60.0f;
+        } else {
+            ImGui_ImplGlfw_NewFrame();
+        }
         ImGui::NewFrame();
         m_frame = true;
     }
 
-    void Window::endFrame() {
-        if(m_window == nullptr) {
-            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
-        }
-        if(!m_frame) {
-            throw exception("Endframe already called.", errorCodes::PNT_ERROR);
-        }
-
-        ImGui::Render();
+    void Window::beginGpuFrame() {
+        flushResources(getShareGroup(), m_openglContext);
+        m_gpuProfiler.beginFrame();
+        m_capture.poll(this);
+        m_screenshotCapture.poll(this);
+        m_imguiRenderer.newFrame();
+    }
 
-        int width, height;
-        glfwGetFramebufferSize(m_window, &width, &height);
+    void Window::drawFrame(ImDrawData* drawData, int width, int height, const float clearColor[4], uint64_t frame) {
         m_openglContext->Viewport(0, 0, width, height);
-        m_openglContext->ClearColor(m_data.clearColor[0], m_data.clearColor[1], m_data.clearColor[2], m_data.clearColor[3]);
+        m_openglContext->ClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+        m_gpuProfiler.beginScope("Clear");
         m_openglContext->Clear(GL_COLOR_BUFFER_BIT);
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-        if (m_IO->ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
+        m_gpuProfiler.endScope();
+        m_gpuProfiler.beginScope("ImGui");
+        m_imguiRenderer.render(drawData);
+        m_gpuProfiler.endScope();
+        if (!m_threaded && m_IO->ConfigFlags & ImGuiConfigFlags_ViewportsEnable) {
             GLFWwindow* backup_current_context = glfwGetCurrentContext();
             ImGui::UpdatePlatformWindows();
             ImGui::RenderPlatformWindowsDefault();
             glfwMakeContextCurrent(backup_current_context);
         }
-        glfwSwapBuffers(m_window);
+        if(m_capture.wanted()) {
+            m_gpuProfiler.beginScope("Capture");
+            m_capture.capture(width, height, frame);
+            m_gpuProfiler.endScope();
+        }
+        if(m_screenshotCapture.wanted()) {
+            std::lock_guard<std::mutex> lock(m_screenshotMutex);
+            m_gpuProfiler.beginScope("Screenshot");
+            if(m_screenshotCapture.capture(width, height, frame)) {
+                for(pendingScreenshot& screenshot : m_screenshots) {
+                    if(screenshot.frame == UINT64_MAX) {
+                        screenshot.frame = frame;
+                    }
+                }
+            }
+            m_gpuProfiler.endScope();
+        }
+    }
+
+    bool Window::renderFrame() {
+        ImGui::SetCurrentContext(m_ImContext);
+
+        if(m_data.performanceOverlay) {
+            drawPerformanceOverlay();
+        }
+        ImGui::Render();
+
+        int width = m_data.width, height = m_data.height;
+        if(m_headless == nullptr) {
+            glfwGetFramebufferSize(m_window, &width, &height);
+        }
+
+        if(m_data.renderMode == renderModes::REACTIVE && !(m_IO->ConfigFlags & ImGuiConfigFlags_ViewportsEnable)) {
+            uint64_t drawDataHash = hashDrawData(ImGui::GetDrawData(), width, height);
+            // A continuous capture is written at a fixed rate, every frame has to reach it even when nothing changed.
+            m_frameSkipped = !m_dirty && !m_capture.wanted() && drawDataHash == m_drawDataHash;
+            m_drawDataHash = drawDataHash;
+        } else {
+            m_frameSkipped = false;
+        }
+        m_dirty = false;
+        m_swapTime = std::chrono::duration<double>(0.0);
+
+        // The render thread draws and presents its own copy. With a target fps this thread moves on right away, otherwise it waits for the render thread to take the previous frame so the swap still paces it.
+        if(m_threaded) {
+            if(!m_frameSkipped) {
+                submitRenderFrame(this, ImGui::GetDrawData(), width, height, m_data.clearColor, m_frameCount, (int)m_data.vsyncMode, m_data.targetFPS <= 0.0);
+            }
+            return false;
+        }
+
+        if(m_currentWindow != this) {
+            makeContextCurrent();
+        }
+        if(!m_frameSkipped) {
+            drawFrame(ImGui::GetDrawData(), width, height, m_data.clearColor, m_frameCount);
+        }
+        m_gpuProfiler.endFrame();
+        return !m_frameSkipped;
+    }
+
+    std::chrono::duration<double> Window::presentFrame(int swapInterval) {
+        std::chrono::steady_clock::time_point swapStart = std::chrono::steady_clock::now();
+        if(m_headless != nullptr) {
+            // Nothing to present, flushing keeps the gpu from running frames ahead the way a swap would.
+            m_openglContext->Flush();
+        } else {
+            // The interval belongs to the context, so it is only set when it changes and with the right context current.
+            if(swapInterval != m_swapInterval) {
+                if(m_currentWindow != this) {
+                    makeContextCurrent();
+                }
+                glfwSwapInterval(swapInterval);
+                m_swapInterval = swapInterval;
+            }
+            traceZone swapZone("glfwSwapBuffers");
+            glfwSwapBuffers(m_window);
+        }
+        return std::chrono::steady_clock::now() - swapStart;
+    }
+
+    void Window::finishFrame() {
         m_frame = false;
+        m_frameCount++;
 
         endframe = std::chrono::steady_clock::now();
         deltaTime = endframe - newframe;
+        traceFrameTime(deltaTime.count());
+        m_frameStats.addSample(frameTiming{m_frameInterval.count(), (deltaTime - m_swapTime).count(), m_swapTime.count(), m_eventTime.count()});
+    }
+
+    void Window::endFrame() {
+        traceZone zone("Window::endFrame");
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+        if(!m_frame) {
+            throw exception("Endframe already called.", errorCodes::PNT_ERROR);
+        }
+
+        if(renderFrame()) {
+            m_swapTime = presentFrame((int)m_data.vsyncMode);
+        }
+        finishFrame();
+        m_pacer.wait();
+    }
+
+    void Window::renderAll() {
+        traceZone zone("Window::renderAll");
+
+        // Every window is rendered before anything is presented, so the gpu works through all of them while the swaps wait.
+        for(Window* window : m_instancesList) {
+            window->m_scheduled = window->m_frame;
+            window->m_presentPending = window->m_frame && window->renderFrame();
+        }
+
+        // Swaps of vsynced windows each block until the next vblank when done one after another, so only the last one waits and the others swap right away.
+        Window* primary = nullptr;
+        for(Window* window : m_instancesList) {
+            if(window->m_presentPending && window->m_headless == nullptr && window->m_data.vsyncMode != vsyncModes::OFF) {
+                primary = window;
+            }
+        }
+        for(Window* window : m_instancesList) {
+            if(window->m_presentPending && window != primary) {
+                window->m_swapTime = window->presentFrame(0);
+            }
+        }
+        if(primary != nullptr) {
+            primary->m_swapTime = primary->presentFrame((int)primary->m_data.vsyncMode);
+        }
+
+        for(Window* window : m_instancesList) {
+            if(window->m_scheduled) {
+                window->m_presentPending = false;
+                window->finishFrame();
+            }
+        }
+        for(Window* window : m_instancesList) {
+            if(window->m_scheduled) {
+                window->m_scheduled = false;
+                window->m_pacer.wait();
+            }
+        }
     }
 
     void Window::setEventCallback(void(*newEventCallback)(Window*, windowEvent)) {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
         m_data.eventCallback = newEventCallback;
     }
 
-    void Window::pushEvent(windowEvent event) {
-        if(m_window == nullptr) {
+    void Window::setEventBatchCallback(void(*newEventBatchCallback)(Window*, std::span<const windowEvent>)) {
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+
+        m_data.eventBatchCallback = newEventBatchCallback;
+    }
+
+    bool Window::pushEvent(windowEvent event) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
         logger.get()->debug("[PNT]Pushing event of type \"{}\" for window \"{}\"", event.getTypename(), m_data.title);
 
-        m_eventQueue.emplace_back(event);
+        storeDropPaths(event);
+        if(!postEvent(event)) {
+            // Logging here would flush the sinks on the producer thread once per drop, during exactly the bursts that fill the queue.
+            m_droppedEvents.fetch_add(1, std::memory_order_relaxed);
+            releaseDropStorage(event);
+            return false;
+        }
+
+        return true;
+    }
+
+    bool Window::postEvent(const windowEvent& event) {
+        // A destroyed window has no queue storage left, the push fails instead of throwing.
+        if(!m_eventQueue.push(event)) {
+            return false;
+        }
+
+        if(std::this_thread::get_id() != mainThread && !m_wakeupPosted.exchange(true, std::memory_order_acq_rel)) {
+            glfwPostEmptyEvent();
+        }
+
+        return true;
+    }
+
+    void Window::dispatchEvent(const windowEvent& event) {
+        if(m_data.coalesceMode == coalesceModes::OFF) {
+            deliverEvent(event);
+            return;
+        }
+
+        switch(event.type) {
+            case eventTypes::SCROLL:
+            case eventTypes::CURSORPOS:
+            case eventTypes::WINDOWPOS:
+            case eventTypes::WINDOWSIZE:
+                break;
+            default:
+                flushCoalescedEvent();
+                deliverEvent(event);
+                return;
+        }
+
+        if(m_data.coalesceMode == coalesceModes::LATEST_WITH_HISTORY) {
+            m_eventSamples.push_back({glfwGetTime(), event});
+        }
+
+        // One slot per type, so interleaved cursor and scroll events don't push each other out.
+        for(size_t i = 0; i < m_coalescedCount; i++) {
+            windowEvent& pending = m_coalescedEvents[i];
+            if(pending.type != event.type) {
+                continue;
+            }
+            if(event.type == eventTypes::SCROLL) {
+                pending.scroll.xoffset += event.scroll.xoffset;
+                pending.scroll.yoffset += event.scroll.yoffset;
+            } else {
+                pending = event;
+            }
+            return;
+        }
+        m_coalescedEvents[m_coalescedCount++] = event;
+    }
+
+    void Window::flushCoalescedEvent() {
+        // Delivered in the order their types first arrived in, from a copy since callbacks may coalesce new events.
+        size_t count = m_coalescedCount;
+        std::array<windowEvent, 4> events = m_coalescedEvents;
+        m_coalescedCount = 0;
+        for(size_t i = 0; i < count; i++) {
+            deliverEvent(events[i]);
+        }
+    }
+
+    void Window::deliverEvent(const windowEvent& event) {
+        if(m_data.eventBatchCallback != nullptr) {
+            windowEvent queued = event;
+            storeDropPaths(queued);
+            // The main thread is the consumer, so a full queue is emptied into the batch instead of losing the event.
+            if(!m_eventQueue.push(queued)) {
+                drainEventQueue(m_eventQueue.size());
+                m_eventBatch.emplace_back(queued);
+            }
+        } else {
+            traceZone zone(event.getTypename());
+            if(m_data.eventCallback != nullptr) {
+                m_data.eventCallback(this, event);
+            }
+            invokeListeners(event);
+        }
+    }
+
+    void Window::invokeListeners(const windowEvent& event) {
+        m_eventCounts[(size_t)event.type]++;
+        std::vector<eventListener>& listeners = m_listeners[(size_t)event.type];
+        if(listeners.empty()) {
+            return;
+        }
+
+        // Listeners added or removed while dispatching are applied once the outermost dispatch is done.
+        m_listenerDepth++;
+        for(const eventListener& listener : listeners) {
+            listener(this, event);
+        }
+        m_listenerDepth--;
+
+        if(m_listenerDepth == 0) {
+            for(std::vector<eventListener>& list : m_listeners) {
+                std::erase_if(list, [](const eventListener& listener) {
+                    return !listener.active();
+                });
+            }
+            for(std::pair<eventTypes, eventListener>& pending : m_pendingListeners) {
+                if(pending.second.active()) {
+                    m_listeners[(size_t)pending.first].emplace_back(std::move(pending.second));
+                }
+            }
+            m_pendingListeners.clear();
+        }
+    }
+
+    size_t Window::addListenerIntern(eventTypes type, eventListener listener) {
+        size_t id = listener.id();
+        if(m_listenerDepth > 0) {
+            m_pendingListeners.emplace_back(type, std::move(listener));
+        } else {
+            m_listeners[(size_t)type].emplace_back(std::move(listener));
+        }
+        return id;
+    }
+
+    void Window::removeListener(size_t id) {
+        for(std::vector<eventListener>& listeners : m_listeners) {
+            for(eventListener& listener : listeners) {
+                if(listener.id() == id) {
+                    listener.deactivate();
+                }
+            }
+            if(m_listenerDepth == 0) {
+                std::erase_if(listeners, [](const eventListener& listener) {
+                    return !listener.active();
+                });
+            }
+        }
+        for(std::pair<eventTypes, eventListener>& pending : m_pendingListeners) {
+            if(pending.second.id() == id) {
+                pending.second.deactivate();
+            }
+        }
+    }
+
+    void Window::drainEventQueue(size_t count) {
+        windowEvent event;
+        while(count-- && m_eventQueue.pop(event)) {
+            m_eventBatch.emplace_back(event);
+        }
+    }
+
+    void Window::storeDropPaths(windowEvent& event) {
+        if(event.type != eventTypes::DROP || event.dropFiles.pathCount <= 0) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_dropStorageMutex);
+        dropStorage& storage = m_dropStorage.emplace_back();
+        storage.paths.assign(event.dropFiles.paths, event.dropFiles.paths + event.dropFiles.pathCount);
+        for(const std::string& path : storage.paths) {
+            storage.pointers.emplace_back(path.c_str());
+        }
+        event.dropFiles.paths = storage.pointers.data();
+    }
+
+    void Window::releaseDropStorage(const windowEvent& event) {
+        if(event.type != eventTypes::DROP) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_dropStorageMutex);
+        m_dropStorage.remove_if([&event](const dropStorage& storage) {
+            return storage.pointers.data() == event.dropFiles.paths;
+        });
+    }
+
+    void Window::makeContextCurrent() {
+        if(m_headless != nullptr) {
+            makeHeadlessCurrent(m_headless);
+        } else {
+            glfwMakeContextCurrent(m_window);
+        }
+        m_currentWindow = this;
+    }
+
+    const void* Window::getShareGroup() const {
+        return m_headless != nullptr ? getHeadlessShareGroup() : m_shareWindow;
+    }
+
+    bool Window::canRenderThreaded() const {
+        // Viewports create and swap their own windows from inside the imgui frame, so they stay on the thread owning the ui.
+        return m_headless == nullptr && !(m_data.ImGuiFlags & ImGuiConfigFlags_ViewportsEnable);
+    }
+
+    GladGLContext* Window::beginResourceUpload() {
+        // Any context of the group can create shared objects, reusing the current one avoids switching contexts in the middle of a frame.
+        if(m_currentWindow != nullptr && m_currentWindow->getShareGroup() == getShareGroup()) {
+            return m_currentWindow->m_openglContext;
+        }
+        if(m_threaded) {
+            // The render thread owns the window contexts, the hidden share context is free on this one.
+            glfwMakeContextCurrent(m_shareWindow);
+            m_currentWindow = nullptr;
+            if(m_shareContext == nullptr) {
+                m_shareContext = new GladGLContext;
+                gladLoadGLContext(m_shareContext, (GLADloadfunc)glfwGetProcAddress);
+            }
+            return m_shareContext;
+        }
+        makeContextCurrent();
+        return m_openglContext;
+    }
+
+    void Window::endResourceUpload(Window* previous, GladGLContext* openglContext) {
+        // A flush only submits the commands, another context (or the render thread) binding the handle right after could still see it incomplete.
+        // Waiting for them to finish makes the object safe to use from any context of the group as soon as this returns.
+        openglContext->Finish();
+        if(previous != nullptr && previous != m_currentWindow) {
+            previous->makeContextCurrent();
+        } else if(openglContext == m_shareContext) {
+            glfwMakeContextCurrent(nullptr);
+        }
+    }
+
+    void Window::feedHeadlessInput(const windowEvent& event) {
+        ImGuiContext* oldImContext = ImGui::GetCurrentContext();
+        ImGui::SetCurrentContext(m_ImContext);
+        switch(event.type) {
+            case eventTypes::KEYBOARD: {
+                // Modifiers go first like in the glfw backend, so shortcuts like ctrl+a see them together with the key.
+                m_IO->AddKeyEvent(ImGuiMod_Ctrl, (event.keyboard.mods & GLFW_MOD_CONTROL) != 0);
+                m_IO->AddKeyEvent(ImGuiMod_Shift, (event.keyboard.mods & GLFW_MOD_SHIFT) != 0);
+                m_IO->AddKeyEvent(ImGuiMod_Alt, (event.keyboard.mods & GLFW_MOD_ALT) != 0);
+                m_IO->AddKeyEvent(ImGuiMod_Super, (event.keyboard.mods & GLFW_MOD_SUPER) != 0);
+                // Imgui generates its own key repeats.
+                if(event.keyboard.action != GLFW_PRESS && event.keyboard.action != GLFW_RELEASE) {
+                    break;
+                }
+                ImGuiKey key = glfwKeyToImGuiKey(event.keyboard.key);
+                m_IO->AddKeyEvent(key, event.keyboard.action == GLFW_PRESS);
+                m_IO->SetKeyEventNativeData(key, event.keyboard.key, event.keyboard.scancode);
+                break;
+            }
+            case eventTypes::CHAR:
+                m_IO->AddInputCharacter(event.character.codepoint);
+                break;
+            case eventTypes::SCROLL:
+                m_IO->AddMouseWheelEvent((float)event.scroll.xoffset, (float)event.scroll.yoffset);
+                break;
+            case eventTypes::CURSORPOS:
+                m_IO->AddMousePosEvent((float)event.cursorpos.xpos, (float)event.cursorpos.ypos);
+                break;
+            case eventTypes::CURSORENTER:
+                if(!event.cursorenter.entered) {
+                    m_IO->AddMousePosEvent(-FLT_MAX, -FLT_MAX);
+                }
+                break;
+            case eventTypes::MOUSEBUTTON:
+                if(event.mousebutton.button >= 0 && event.mousebutton.button < ImGuiMouseButton_COUNT) {
+                    m_IO->AddMouseButtonEvent(event.mousebutton.button, event.mousebutton.action == GLFW_PRESS);
+                }
+                break;
+            case eventTypes::WINDOWFOCUS:
+                m_data.focused = event.windowfocus.focused;
+                m_IO->AddFocusEvent(event.windowfocus.focused != 0);
+                break;
+            case eventTypes::WINDOWSIZE:
+                m_data.width = event.windowsize.width;
+                m_data.height = event.windowsize.height;
+                break;
+            case eventTypes::WINDOWPOS:
+                m_data.xpos = event.windowpos.xpos;
+                m_data.ypos = event.windowpos.ypos;
+                break;
+            case eventTypes::ICONIFY:
+                m_data.iconified = event.iconified;
+                break;
+            default:
+                break;
+        }
+        ImGui::SetCurrentContext(oldImContext);
+    }
+
+    void Window::drawPerformanceOverlay() {
+        const ImGuiViewport* viewport = ImGui::GetMainViewport();
+        ImGui::SetNextWindowPos(ImVec2(viewport->WorkPos.x + 8.0f, viewport->WorkPos.y + 8.0f), ImGuiCond_Always);
+        ImGui::SetNextWindowBgAlpha(0.75f);
+        if(!ImGui::Begin("Performance##PNT", nullptr, ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav)) {
+            ImGui::End();
+            return;
+        }
+
+        char overlayText[32];
+        int samples = (int)m_frameStats.size();
+        double frameTime = samples ? m_frameStats.value(frameMetrics::FRAME, 0) : 0.0;
+        overlayPlot frameTimes{&m_frameStats, false};
+        overlayPlot frameRates{&m_frameStats, true};
+        std::snprintf(overlayText, sizeof(overlayText), "%.2f ms", frameTime * 1000.0);
+        ImGui::PlotLines("Frame time", overlayPlotValue, &frameTimes, samples, 0, overlayText, 0.0f, FLT_MAX, ImVec2(240.0f, 48.0f));
+        std::snprintf(overlayText, sizeof(overlayText), "%.1f fps", frameTime > 0.0 ? 1.0 / frameTime : 0.0);
+        ImGui::PlotLines("FPS", overlayPlotValue, &frameRates, samples, 0, overlayText, 0.0f, FLT_MAX, ImVec2(240.0f, 48.0f));
+
+        ImGui::Separator();
+        if(ImGui::BeginTable("CPU##PNT", 5, ImGuiTableFlags_SizingFixedFit)) {
+            static const char* metricNames[frameMetricCount] = {"Frame", "CPU", "Swap", "Events"};
+            ImGui::TableSetupColumn("ms");
+            ImGui::TableSetupColumn("p50");
+            ImGui::TableSetupColumn("p95");
+            ImGui::TableSetupColumn("p99");
+            ImGui::TableSetupColumn("max");
+            ImGui::TableHeadersRow();
+            for(size_t i = 0; i < frameMetricCount; i++) {
+                frameSummary summary = m_frameStats.summary((frameMetrics)i);
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(metricNames[i]);
+                for(double value : {summary.p50, summary.p95, summary.p99, summary.max}) {
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.2f", value * 1000.0);
+                }
+            }
+            ImGui::EndTable();
+        }
+
+        ImGui::Separator();
+        if(m_gpuProfiler.getEnabled()) {
+            m_gpuProfiler.getResults(m_overlayScopes);
+            for(const gpuScopeResult& scope : m_overlayScopes) {
+                ImGui::Text("GPU %*s%s: %.3f ms", scope.depth * 2, "", scope.name, scope.time * 1000.0);
+            }
+        } else {
+            ImGui::TextUnformatted("GPU timings unavailable");
+        }
+
+        ImGui::Separator();
+        if(ImGui::BeginTable("Events##PNT", 2, ImGuiTableFlags_SizingFixedFit)) {
+            windowEvent event{};
+            for(size_t i = 0; i < eventTypeCount; i++) {
+                event.type = (eventTypes)i;
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn();
+                ImGui::TextUnformatted(event.getTypename());
+                ImGui::TableNextColumn();
+                ImGui::Text("%u", m_eventCounts[i]);
+            }
+            ImGui::EndTable();
+        }
+        ImGui::Text("Queue depth: %zu / %zu", m_queueDepth, m_eventQueue.capacity());
+
+        if(getAllocationTracking()) {
+            // The counter is global, this is every allocation of the process (all threads and windows) since this overlay was last drawn.
+            uint64_t allocations = getAllocationCount();
+            ImGui::Text("Process allocations since last refresh: %llu", (unsigned long long)(allocations - m_allocationMark));
+            m_allocationMark = allocations;
+        } else {
+            ImGui::TextUnformatted("Process allocations: build with PNT_TRACK_ALLOCATIONS");
+        }
+        ImGui::End();
+    }
+
+    void Window::setCoalesceMode(coalesceModes coalesceMode) {
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+
+        m_data.coalesceMode = coalesceMode;
+        if(coalesceMode == coalesceModes::OFF) {
+            flushCoalescedEvent();
+        }
+        if(coalesceMode != coalesceModes::LATEST_WITH_HISTORY) {
+            m_eventSamples.clear();
+        }
     }
 
     void Window::setUserPointer(void* pointer) {
@@ -207,34 +1022,44 @@ namespace PNT {
     }
 
     void Window::setWindowData(windowData newData) {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
         m_data.eventCallback = newData.eventCallback;
+        m_data.eventBatchCallback = newData.eventBatchCallback;
+        setCoalesceMode(newData.coalesceMode);
         setTitle(newData.title);
         setDimentions(newData.width, newData.height);
         setPosition(newData.xpos, newData.ypos);
         setVsyncMode(newData.vsyncMode);
+        setRenderMode(newData.renderMode);
+        setTargetFPS(newData.targetFPS);
         newData.hidden ? show() : hide();
         newData.iconified ? minimize() : maximize();
         setClearColor(newData.clearColor[0], newData.clearColor[1], newData.clearColor[2], newData.clearColor[3]);
     }
 
     void Window::setTitle(const std::string& title) {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
         this->m_data.title = title;
-        glfwSetWindowTitle(m_window, title.c_str());
+        if(m_headless == nullptr) {
+            glfwSetWindowTitle(m_window, title.c_str());
+        }
     }
 
     void Window::setIcon(const GLFWimage& icon) {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
+        if(m_headless != nullptr) {
+            return;
+        }
+
         logger.get()->debug("[PNT]Setting icon for window \"{}\"", m_data.title);
 
         if(icon.pixels != nullptr) {
@@ -246,80 +1071,356 @@ namespace PNT {
     }
 
     void Window::setDimentions(int width, int height) {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
+        if(m_headless != nullptr) {
+            m_data.width = width;
+            m_data.height = height;
+            dispatchEvent(createWindowsizeEvent(width, height));
+            return;
+        }
+
         glfwSetWindowSize(m_window, width, height);
+        m_applyingRequest = true;
         callbackManagers::windowsizeCallbackManager(m_window, width, height);
+        m_applyingRequest = false;
     }
 
     void Window::setFocused() {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
+        if(m_headless != nullptr) {
+            m_data.focused = true;
+            dispatchEvent(createWindowFocusEvent(1));
+            return;
+        }
+
         glfwFocusWindow(m_window);
+        m_applyingRequest = true;
         callbackManagers::windowFocusCallback(m_window, 1);
+        m_applyingRequest = false;
     }
 
     void Window::setPosition(int xpos, int ypos) {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
         if((xpos == GLFW_DONT_CARE) and (ypos == GLFW_DONT_CARE)) {
             return;
         }
 
+        if(m_headless != nullptr) {
+            m_data.xpos = xpos;
+            m_data.ypos = ypos;
+            dispatchEvent(createWindowposEvent(xpos, ypos));
+            return;
+        }
+
         glfwSetWindowPos(m_window, xpos, ypos);
+        m_applyingRequest = true;
         callbackManagers::windowposCallbackManager(m_window, xpos, ypos);
+        m_applyingRequest = false;
     }
 
     void Window::hide() {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
-        glfwHideWindow(m_window);
+        if(m_headless == nullptr) {
+            glfwHideWindow(m_window);
+        }
     }
 
     void Window::show() {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
-        glfwShowWindow(m_window);
+        if(m_headless == nullptr) {
+            glfwShowWindow(m_window);
+        }
     }
 
     void Window::minimize() {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
+        if(m_headless != nullptr) {
+            m_data.iconified = true;
+            dispatchEvent(createIconifyEvent(1));
+            return;
+        }
+
         glfwIconifyWindow(m_window);
+        m_applyingRequest = true;
         callbackManagers::iconifyCallbackManager(m_window, 1);
+        m_applyingRequest = false;
     }
 
     void Window::maximize() {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
+        if(m_headless != nullptr) {
+            m_data.iconified = false;
+            dispatchEvent(createIconifyEvent(0));
+            return;
+        }
+
         glfwRestoreWindow(m_window);
+        m_applyingRequest = true;
         callbackManagers::iconifyCallbackManager(m_window, 0);
+        m_applyingRequest = false;
     }
 
     void Window::setVsyncMode(vsyncModes vsyncMode) {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
+        // Applied by the next present, with this window's context current rather than whichever one is current now.
         m_data.vsyncMode = vsyncMode;
-        glfwSwapInterval((int)vsyncMode);
+    }
+
+    void Window::setTargetFPS(double fps) {
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+
+        m_data.targetFPS = fps;
+        m_pacer.setTargetFPS(fps);
+    }
+
+    void Window::setRenderMode(renderModes renderMode) {
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+
+        m_data.renderMode = renderMode;
+        m_dirty = true;
+    }
+
+    void Window::markDirty() {
+        m_dirty = true;
+    }
+
+    bool Window::getFrameSkipped() const {
+        return m_frameSkipped;
+    }
+
+    void Window::setCaptureCallback(void(*callback)(Window*, const capturedFrame&, void*), void* userData) {
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+
+        m_capture.setCallback(callback, userData);
+    }
+
+    void Window::setContinuousCapture(bool continuous) {
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+
+        m_capture.setContinuous(continuous);
+        m_dirty = true;
+    }
+
+    void Window::requestCapture() {
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+
+        m_capture.request();
+        // Skipped frames have nothing to read back.
+        m_dirty = true;
+    }
+
+    GLuint Window::createTextureIntern(int width, int height, const unsigned char* pixels) {
+        Window* previous = m_currentWindow;
+        GladGLContext* gl = beginResourceUpload();
+        GLint lastTexture, lastRowLength, lastAlignment;
+        gl->GetIntegerv(GL_TEXTURE_BINDING_2D, &lastTexture);
+        gl->GetIntegerv(GL_UNPACK_ROW_LENGTH, &lastRowLength);
+        gl->GetIntegerv(GL_UNPACK_ALIGNMENT, &lastAlignment);
+
+        GLuint texture = 0;
+        gl->GenTextures(1, &texture);
+        gl->BindTexture(GL_TEXTURE_2D, texture);
+        gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        gl->TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        gl->PixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        gl->PixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        gl->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        gl->PixelStorei(GL_UNPACK_ROW_LENGTH, lastRowLength);
+        gl->PixelStorei(GL_UNPACK_ALIGNMENT, lastAlignment);
+        gl->BindTexture(GL_TEXTURE_2D, (GLuint)lastTexture);
+        endResourceUpload(previous, gl);
+        return texture;
+    }
+
+    gpuResource Window::createTexture(int width, int height, const unsigned char* pixels) {
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+
+        return createResource(getShareGroup(), resourceTypes::TEXTURE, createTextureIntern(width, height, pixels), "");
+    }
+
+    gpuResource Window::loadTexture(const std::string& path) {
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+
+        gpuResource texture = findResource(getShareGroup(), path);
+        if(texture.valid()) {
+            return texture;
+        }
+
+        int width, height, channels;
+        unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+        if(pixels == nullptr) {
+            logger.get()->error("[PNT]Failed to load texture \"{}\": {}", path, stbi_failure_reason());
+            return gpuResource();
+        }
+        logger.get()->debug("[PNT]Loaded texture \"{}\" ({}x{})", path, width, height);
+
+        GLuint uploaded = createTextureIntern(width, height, pixels);
+        stbi_image_free(pixels);
+
+        // Registered under the path so every other window gets this texture instead of uploading its own.
+        return createResource(getShareGroup(), resourceTypes::TEXTURE, uploaded, path);
+    }
+
+    gpuResource Window::createBuffer(GLsizeiptr size, const void* data, GLenum usage) {
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+
+        Window* previous = m_currentWindow;
+        GladGLContext* gl = beginResourceUpload();
+        GLint lastArrayBuffer;
+        gl->GetIntegerv(GL_ARRAY_BUFFER_BINDING, &lastArrayBuffer);
+
+        GLuint buffer = 0;
+        gl->GenBuffers(1, &buffer);
+        gl->BindBuffer(GL_ARRAY_BUFFER, buffer);
+        gl->BufferData(GL_ARRAY_BUFFER, size, data, usage);
+        gl->BindBuffer(GL_ARRAY_BUFFER, (GLuint)lastArrayBuffer);
+        endResourceUpload(previous, gl);
+
+        return createResource(getShareGroup(), resourceTypes::BUFFER, buffer, "");
+    }
+
+    gpuResource Window::createProgram(const std::string& vertexSource, const std::string& fragmentSource) {
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+
+        Window* previous = m_currentWindow;
+        GladGLContext* gl = beginResourceUpload();
+
+        GLuint program = gl->CreateProgram();
+        const char* sources[2] = {vertexSource.c_str(), fragmentSource.c_str()};
+        const GLenum stages[2] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+        bool compiled = true;
+        for(int i = 0; i < 2; i++) {
+            GLuint shader = gl->CreateShader(stages[i]);
+            gl->ShaderSource(shader, 1, &sources[i], nullptr);
+            gl->CompileShader(shader);
+            GLint status = 0;
+            gl->GetShaderiv(shader, GL_COMPILE_STATUS, &status);
+            if(!status) {
+                char log[1024] = {0};
+                gl->GetShaderInfoLog(shader, sizeof(log), nullptr, log);
+                logger.get()->error("[PNT]Failed to compile {} shader: {}", i == 0 ? "vertex" : "fragment", log);
+                compiled = false;
+            }
+            gl->AttachShader(program, shader);
+            // Flagged for deletion, it goes away with the program.
+            gl->DeleteShader(shader);
+        }
+
+        GLint status = 0;
+        if(compiled) {
+            gl->LinkProgram(program);
+            gl->GetProgramiv(program, GL_LINK_STATUS, &status);
+            if(!status) {
+                char log[1024] = {0};
+                gl->GetProgramInfoLog(program, sizeof(log), nullptr, log);
+                logger.get()->error("[PNT]Failed to link program: {}", log);
+            }
+        }
+        if(!status) {
+            gl->DeleteProgram(program);
+            endResourceUpload(previous, gl);
+            return gpuResource();
+        }
+        endResourceUpload(previous, gl);
+
+        return createResource(getShareGroup(), resourceTypes::PROGRAM, program, "");
+    }
+
+    uint64_t Window::requestScreenshot(const std::string& path) {
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+
+        uint64_t id = m_nextScreenshotId++;
+        if(!m_openglContext->VERSION_3_2) {
+            logger.get()->warn("[PNT]Screenshots need OpenGL 3.2 fences");
+            pushEvent(createScreenshotEvent(id, false));
+            return id;
+        }
+        std::lock_guard<std::mutex> lock(m_screenshotMutex);
+        m_screenshots.emplace_back(pendingScreenshot{id, UINT64_MAX, path});
+        m_screenshotCapture.request();
+        m_dirty = true;
+        return id;
+    }
+
+    void Window::screenshotCallback(Window* window, const capturedFrame& frame, void*) {
+        // Every screenshot requested before the capture shares the frame, each gets its own copy for the encoder.
+        std::lock_guard<std::mutex> lock(window->m_screenshotMutex);
+        std::erase_if(window->m_screenshots, [window, &frame](pendingScreenshot& screenshot) {
+            if(screenshot.frame != frame.frame) {
+                return false;
+            }
+            queueScreenshot(window, screenshot.id, std::move(screenshot.path), frame.width, frame.height, std::vector<unsigned char>(frame.pixels.begin(), frame.pixels.end()));
+            return true;
+        });
+    }
+
+    void Window::setPerformanceOverlay(bool shown) {
+        if(m_window == nullptr && m_headless == nullptr) {
+            throw exception("Window not initalized.", errorCodes::PNT_ERROR);
+        }
+        if(shown == m_data.performanceOverlay) {
+            return;
+        }
+
+        m_data.performanceOverlay = shown;
+        m_allocationMark = getAllocationCount();
+        // The profiler applies the change at the start of its next frame, on whichever thread renders this window.
+        if(shown) {
+            m_overlayEnabledProfiler = !m_gpuProfiler.getEnabled();
+            m_gpuProfiler.setEnabled(true);
+        } else if(m_overlayEnabledProfiler) {
+            m_gpuProfiler.setEnabled(false);
+            m_overlayEnabledProfiler = false;
+        }
     }
 
     void Window::setClearColor(float red, float green, float blue, float alpha) {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
@@ -327,34 +1428,72 @@ namespace PNT {
         m_data.clearColor[1] = green;
         m_data.clearColor[2] = blue;
         m_data.clearColor[3] = alpha;
+        m_dirty = true;
     }
 
     void Window::setShouldClose(bool shouldClose) {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
+        if(m_headless != nullptr) {
+            m_headlessShouldClose = shouldClose;
+            return;
+        }
+
         glfwSetWindowShouldClose(m_window, shouldClose);
     }
 
     void Window::setAspectRatio(int numerator, int denominator) {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
+        if(m_headless != nullptr) {
+            return;
+        }
+
         logger.get()->debug("[PNT]Setting aspect ratio: {}, {} for window \"{}\"", numerator, denominator,m_data.title);
 
         glfwSetWindowAspectRatio(m_window, numerator, denominator);
     }
 
     std::chrono::duration<double> Window::getDeltaTime() const {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
         return deltaTime;
     }
 
+    void Window::setFrameStatsCapacity(size_t frames) {
+        m_frameStats.setCapacity(frames);
+    }
+
+    const frameStats& Window::getFrameStats() const {
+        return m_frameStats;
+    }
+
+    gpuProfiler& Window::getGpuProfiler() {
+        return m_gpuProfiler;
+    }
+
+    uint64_t Window::getDroppedCaptures() const {
+        return m_capture.getDropped();
+    }
+
+    bool Window::getPerformanceOverlay() const {
+        return m_data.performanceOverlay;
+    }
+
+    std::chrono::duration<double> Window::getFrameSlack() const {
+        return m_pacer.getSlack();
+    }
+
+    std::span<const eventSample> Window::getEventSamples() const {
+        return m_eventSamples;
+    }
+
     void* Window::getUserPointer() const {
         return m_data.userPointer;
     }
@@ -364,7 +1503,7 @@ namespace PNT {
     }
 
     std::string Window::getTitle() const {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
@@ -372,7 +1511,7 @@ namespace PNT {
     }
 
     int Window::getWidth() const {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
@@ -380,7 +1519,7 @@ namespace PNT {
     }
 
     int Window::getHeight() const {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
@@ -388,7 +1527,7 @@ namespace PNT {
     }
 
     bool Window::getFocus() const {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
@@ -396,7 +1535,7 @@ namespace PNT {
     }
 
     int Window::getXPos() const {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
@@ -404,7 +1543,7 @@ namespace PNT {
     }
 
     int Window::getYPos() const {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
@@ -412,7 +1551,7 @@ namespace PNT {
     }
 
     bool Window::getHidden() const {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
@@ -420,7 +1559,7 @@ namespace PNT {
     }
 
     bool Window::getIconified() const {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
@@ -428,7 +1567,7 @@ namespace PNT {
     }
 
     const GladGLContext* Window::getGL() const {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
@@ -436,10 +1575,14 @@ namespace PNT {
     }
 
     bool Window::shouldClose() const {
-        if(m_window == nullptr) {
+        if(m_window == nullptr && m_headless == nullptr) {
             throw exception("Window not initalized.", errorCodes::PNT_ERROR);
         }
 
+        if(m_headless != nullptr) {
+            return m_headlessShouldClose;
+        }
+
         return glfwWindowShouldClose(m_window);
     }
 
@@ -447,6 +1590,14 @@ namespace PNT {
         return m_window;
     }
 
+    bool Window::getHeadless() const {
+        return m_headless != nullptr;
+    }
+
+    GLuint Window::getFramebuffer() const {
+        return m_headless != nullptr ? getHeadlessFramebuffer(m_headless) : 0;
+    }
+
     // Callback definitions.
 
     void monitorCallback(GLFWmonitor* monitor, int event) {
@@ -455,109 +1606,165 @@ namespace PNT {
 
     void callbackManagers::keyCallbackManager(GLFWwindow* glfwWindow, int key, int scancode, int action, int mods) {
         Window* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
+        Window::m_glfwEventCount++;
+        windowEvent event = createKeyEvent(key, scancode, action, mods);
+        bool deliver = captureInputEvent(window, event);
+
+        // Held back input must not reach imgui either, a stray key or mouse move would change its hover, focus and text state mid replay.
+        if(!deliver) {
+            return;
+        }
 
         ImGuiContext* oldImContext = ImGui::GetCurrentContext();
         ImGui::SetCurrentContext(window->m_ImContext);
         ImGui_ImplGlfw_KeyCallback(glfwWindow, key, scancode, action, mods);
         ImGui::SetCurrentContext(oldImContext);
 
-        if(!window->m_IO->WantCaptureKeyboard && window->m_data.eventCallback != nullptr) {
-            window->m_data.eventCallback(window, createKeyEvent(key, scancode, action, mods));
+        if(!window->m_IO->WantCaptureKeyboard) {
+            window->dispatchEvent(event);
         }
     }
 
     void callbackManagers::charCallbackManager(GLFWwindow* glfwWindow, unsigned int codepoint) {
         Window* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
+        Window::m_glfwEventCount++;
+        windowEvent event = createCharEvent(codepoint);
+        bool deliver = captureInputEvent(window, event);
+
+        if(!deliver) {
+            return;
+        }
 
         ImGuiContext* oldImContext = ImGui::GetCurrentContext();
         ImGui::SetCurrentContext(window->m_ImContext);
         ImGui_ImplGlfw_CharCallback(glfwWindow, codepoint);
         ImGui::SetCurrentContext(oldImContext);
 
-        if(!window->m_IO->WantCaptureKeyboard && window->m_data.eventCallback != nullptr) {
-            window->m_data.eventCallback(window, createCharEvent(codepoint));
+        if(!window->m_IO->WantCaptureKeyboard) {
+            window->dispatchEvent(event);
         }
     }
 
     void callbackManagers::dropCallbackManager(GLFWwindow* glfwWindow, int path_count, const char** paths) {
         Window* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
-        if(window->m_data.eventCallback != nullptr) {
-            window->m_data.eventCallback(window, createDropEvent(path_count, paths));
+        Window::m_glfwEventCount++;
+        windowEvent event = createDropEvent(path_count, paths);
+        bool deliver = captureInputEvent(window, event);
+        if(deliver) {
+            window->dispatchEvent(event);
         }
     }
 
     void callbackManagers::scrollCallbackManager(GLFWwindow* glfwWindow, double xoffset, double yoffset) {
         Window* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
+        Window::m_glfwEventCount++;
+        windowEvent event = createScrollEvent(xoffset, yoffset);
+        bool deliver = captureInputEvent(window, event);
+
+        if(!deliver) {
+            return;
+        }
 
         ImGuiContext* oldImContext = ImGui::GetCurrentContext();
         ImGui::SetCurrentContext(window->m_ImContext);
         ImGui_ImplGlfw_ScrollCallback(glfwWindow, xoffset, yoffset);
         ImGui::SetCurrentContext(oldImContext);
 
-        if(!window->m_IO->WantCaptureMouse && window->m_data.eventCallback != nullptr) {
-            window->m_data.eventCallback(window, createScrollEvent(xoffset, yoffset));
+        if(!window->m_IO->WantCaptureMouse) {
+            window->dispatchEvent(event);
         }
     }
 
     void callbackManagers::cursorPosCallbackManager(GLFWwindow* glfwWindow, double xpos, double ypos) {
         Window* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
+        Window::m_glfwEventCount++;
+        windowEvent event = createCursorposEvent(xpos, ypos);
+        bool deliver = captureInputEvent(window, event);
+
+        if(!deliver) {
+            return;
+        }
 
         ImGuiContext* oldImContext = ImGui::GetCurrentContext();
         ImGui::SetCurrentContext(window->m_ImContext);
         ImGui_ImplGlfw_CursorPosCallback(glfwWindow, xpos, ypos);
         ImGui::SetCurrentContext(oldImContext);
 
-        if(!window->m_IO->WantCaptureMouse && window->m_data.eventCallback != nullptr) {
-            window->m_data.eventCallback(window, createCursorposEvent(xpos, ypos));
+        if(!window->m_IO->WantCaptureMouse) {
+            window->dispatchEvent(event);
         }
     }
 
     void callbackManagers::windowposCallbackManager(GLFWwindow* glfwWindow, int xpos, int ypos) {
         Window* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
+        Window::m_glfwEventCount++;
+        windowEvent event = createWindowposEvent(xpos, ypos);
+        // Changes the app asked for aren't input, they are neither recorded nor held back by a replay.
+        bool deliver = window->m_applyingRequest || captureInputEvent(window, event);
         window->m_data.xpos = xpos;
         window->m_data.ypos = ypos;
-        if(window->m_data.eventCallback != nullptr) {
-            window->m_data.eventCallback(window, createWindowposEvent(xpos, ypos));
+        if(deliver) {
+            window->dispatchEvent(event);
         }
     }
 
     void callbackManagers::windowsizeCallbackManager(GLFWwindow* glfwWindow, int width, int height) {
         Window* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
+        Window::m_glfwEventCount++;
+        windowEvent event = createWindowsizeEvent(width, height);
+        // Changes the app asked for aren't input, they are neither recorded nor held back by a replay.
+        bool deliver = window->m_applyingRequest || captureInputEvent(window, event);
         window->m_data.width = width;
         window->m_data.height = height;
-        if(window->m_data.eventCallback != nullptr) {
-            window->m_data.eventCallback(window, createWindowsizeEvent(width, height));
+        if(deliver) {
+            window->dispatchEvent(event);
         }
     }
 
     void callbackManagers::cursorEnterCallback(GLFWwindow* glfwWindow, int entered) {
         Window* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
+        Window::m_glfwEventCount++;
+        windowEvent event = createCursorEnterEvent(entered);
+        bool deliver = captureInputEvent(window, event);
+
+        if(!deliver) {
+            return;
+        }
 
         ImGuiContext* oldImContext = ImGui::GetCurrentContext();
         ImGui::SetCurrentContext(window->m_ImContext);
         ImGui_ImplGlfw_CursorEnterCallback(glfwWindow, entered);
         ImGui::SetCurrentContext(oldImContext);
 
-        if(window->m_data.eventCallback != nullptr) {
-            window->m_data.eventCallback(window, createCursorEnterEvent(entered));
-        }
+        window->dispatchEvent(event);
     }
 
     void callbackManagers::mousebuttonCallbackManager(GLFWwindow* glfwWindow, int button, int action, int mods) {
         Window* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
+        Window::m_glfwEventCount++;
+        windowEvent event = createMousebuttonEvent(button, action, mods);
+        bool deliver = captureInputEvent(window, event);
+
+        if(!deliver) {
+            return;
+        }
 
         ImGuiContext* oldImContext = ImGui::GetCurrentContext();
         ImGui::SetCurrentContext(window->m_ImContext);
         ImGui_ImplGlfw_MouseButtonCallback(glfwWindow, button, action, mods);
         ImGui::SetCurrentContext(oldImContext);
 
-        if(!window->m_IO->WantCaptureMouse && window->m_data.eventCallback != nullptr) {
-            window->m_data.eventCallback(window, createMousebuttonEvent(button, action, mods));
+        if(!window->m_IO->WantCaptureMouse) {
+            window->dispatchEvent(event);
         }
     }
 
     void callbackManagers::windowFocusCallback(GLFWwindow* glfwWindow, int focused) {
         Window* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
+        Window::m_glfwEventCount++;
+        windowEvent event = createWindowFocusEvent(focused);
+        // Changes the app asked for aren't input, they are neither recorded nor held back by a replay.
+        bool deliver = window->m_applyingRequest || captureInputEvent(window, event);
         window->m_data.focused = focused;
 
         ImGuiContext* oldImContext = ImGui::GetCurrentContext();
@@ -565,16 +1772,26 @@ namespace PNT {
         ImGui_ImplGlfw_WindowFocusCallback(glfwWindow, focused);
         ImGui::SetCurrentContext(oldImContext);
 
-        if(window->m_data.eventCallback != nullptr) {
-            window->m_data.eventCallback(window, createWindowFocusEvent(focused));
+        if(deliver) {
+            window->dispatchEvent(event);
         }
     }
 
     void callbackManagers::iconifyCallbackManager(GLFWwindow* glfwWindow, int iconified) {
         Window* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
+        Window::m_glfwEventCount++;
+        windowEvent event = createIconifyEvent(iconified);
+        // Changes the app asked for aren't input, they are neither recorded nor held back by a replay.
+        bool deliver = window->m_applyingRequest || captureInputEvent(window, event);
         window->m_data.iconified = iconified;
-        if(window->m_data.eventCallback != nullptr) {
-            window->m_data.eventCallback(window, createIconifyEvent(iconified));
+        if(deliver) {
+            window->dispatchEvent(event);
         }
     }
+
+    void callbackManagers::windowRefreshCallbackManager(GLFWwindow* glfwWindow) {
+        Window* window = static_cast<Window*>(glfwGetWindowUserPointer(glfwWindow));
+        Window::m_glfwEventCount++;
+        window->markDirty();
+    }
 }